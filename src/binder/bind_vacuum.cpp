@@ -0,0 +1,24 @@
+#include <memory>
+#include <optional>
+
+#include "binder/binder.h"
+#include "binder/statement/vacuum_statement.h"
+#include "common/exception.h"
+#include "nodes/parsenodes.hpp"
+
+namespace bustub {
+
+auto Binder::BindVacuum(duckdb_libpgquery::PGVacuumStmt *stmt) -> std::unique_ptr<VacuumStatement> {
+  if ((stmt->options & duckdb_libpgquery::PG_VACOPT_ANALYZE) != 0) {
+    throw NotImplementedException("ANALYZE is not supported");
+  }
+  if (stmt->va_cols != nullptr) {
+    throw NotImplementedException("VACUUM of columns is not supported");
+  }
+  if (stmt->relation == nullptr) {
+    return std::make_unique<VacuumStatement>(nullptr);
+  }
+  return std::make_unique<VacuumStatement>(BindBaseTableRef(stmt->relation->relname, std::nullopt));
+}
+
+}  // namespace bustub
@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.cpp
+//
+// Identification: src/buffer/arc_replacer.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+ARCReplacer::ARCReplacer(size_t num_frames) : frames_(num_frames) {}
+
+auto ARCReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock lock(latch_);
+  const frame_id_t t1_victim = FindVictim(t1_);
+  const frame_id_t t2_victim = FindVictim(t2_);
+  if (t1_victim == INVALID_FRAME_ID && t2_victim == INVALID_FRAME_ID) {
+    return false;
+  }
+  const bool from_t1 = t1_victim != INVALID_FRAME_ID && (t1_.size() > p_ || t2_victim == INVALID_FRAME_ID);
+  *frame_id = from_t1 ? t1_victim : t2_victim;
+
+  const page_id_t page_id = frames_[*frame_id].page_id_;
+  Drop(*frame_id);
+  if (page_id != INVALID_PAGE_ID) {
+    (from_t1 ? b1_ : b2_).Push(page_id);
+    TrimGhosts();
+  }
+  return true;
+}
+
+void ARCReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type, page_id_t page_id) {
+  std::scoped_lock lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "invalid frame id");
+  auto &entry = frames_[frame_id];
+  if (entry.list_ != ListId::None) {
+    // A hit. Only a repeated non-scan access shows that the page is used frequently.
+    MoveTo(frame_id, entry.list_ == ListId::T1 && access_type == AccessType::Scan ? ListId::T1 : ListId::T2);
+    return;
+  }
+
+  // A new page was loaded into the frame; if it was evicted recently, adapt the target size of T1.
+  entry.page_id_ = page_id;
+  const size_t b1_size = b1_.Size();
+  const size_t b2_size = b2_.Size();
+  if (page_id != INVALID_PAGE_ID && b1_.Erase(page_id)) {
+    p_ = std::min(frames_.size(), p_ + std::max<size_t>(b2_size / b1_size, 1));
+    MoveTo(frame_id, ListId::T2);
+  } else if (page_id != INVALID_PAGE_ID && b2_.Erase(page_id)) {
+    p_ -= std::min(p_, std::max<size_t>(b1_size / b2_size, 1));
+    MoveTo(frame_id, ListId::T2);
+  } else {
+    MoveTo(frame_id, ListId::T1);
+  }
+  TrimGhosts();
+}
+
+void ARCReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "invalid frame id");
+  std::scoped_lock lock(latch_);
+  auto &entry = frames_[frame_id];
+  if (entry.list_ == ListId::None || entry.evictable_ == set_evictable) {
+    return;
+  }
+  entry.evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
+
+void ARCReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock lock(latch_);
+  if (frames_[frame_id].list_ == ListId::None) {
+    return;
+  }
+  BUSTUB_ASSERT(frames_[frame_id].evictable_, "cannot remove a non-evictable frame");
+  Drop(frame_id);
+}
+
+auto ARCReplacer::Size() -> size_t {
+  std::scoped_lock lock(latch_);
+  return curr_size_;
+}
+
+void ARCReplacer::Resize(size_t num_frames) {
+  std::scoped_lock lock(latch_);
+  frames_.resize(num_frames);
+  p_ = std::min(p_, num_frames);
+  TrimGhosts();
+}
+
+auto ARCReplacer::GetTargetT1Size() -> size_t {
+  std::scoped_lock lock(latch_);
+  return p_;
+}
+
+auto ARCReplacer::FindVictim(const std::list<frame_id_t> &list) const -> frame_id_t {
+  auto it = std::find_if(list.begin(), list.end(), [this](frame_id_t fid) { return frames_[fid].evictable_; });
+  return it == list.end() ? INVALID_FRAME_ID : *it;
+}
+
+void ARCReplacer::MoveTo(frame_id_t frame_id, ListId list_id) {
+  auto &entry = frames_[frame_id];
+  if (entry.list_ != ListId::None) {
+    GetList(entry.list_).erase(entry.position_);
+  }
+  auto &list = GetList(list_id);
+  entry.list_ = list_id;
+  entry.position_ = list.insert(list.end(), frame_id);
+}
+
+void ARCReplacer::Drop(frame_id_t frame_id) {
+  auto &entry = frames_[frame_id];
+  GetList(entry.list_).erase(entry.position_);
+  entry.list_ = ListId::None;
+  entry.page_id_ = INVALID_PAGE_ID;
+  if (entry.evictable_) {
+    entry.evictable_ = false;
+    curr_size_--;
+  }
+}
+
+void ARCReplacer::TrimGhosts() {
+  // Like the original ARC directory: |T1| + |B1| <= c and |T1| + |T2| + |B1| + |B2| <= 2c.
+  const size_t capacity = frames_.size();
+  while (b1_.Size() > 0 && t1_.size() + b1_.Size() > capacity) {
+    b1_.PopOldest();
+  }
+  while (b2_.Size() > 0 && t1_.size() + t2_.size() + b1_.Size() + b2_.Size() > 2 * capacity) {
+    b2_.PopOldest();
+  }
+}
+
+}  // namespace bustub
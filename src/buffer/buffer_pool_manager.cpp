@@ -12,56 +12,453 @@
 
 #include "buffer/buffer_pool_manager.h"
 
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <new>
+
 #include "common/exception.h"
 #include "common/macros.h"
 #include "storage/page/page_guard.h"
 
 namespace bustub {
 
+namespace {
+
+/** @return `size` rounded up to a multiple of `alignment` */
+auto RoundUp(size_t size, size_t alignment) -> size_t { return (size + alignment - 1) / alignment * alignment; }
+
+/** @return `size` rounded down to a multiple of `alignment` */
+auto RoundDown(size_t size, size_t alignment) -> size_t { return size / alignment * alignment; }
+
+/** @return a private anonymous mapping of `size` bytes that is reserved but not committed yet */
+auto Reserve(size_t size) -> void * {
+  void *memory = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (memory == MAP_FAILED) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot reserve the buffer pool frames");
+  }
+  return memory;
+}
+
+/**
+ * @return a reservation like Reserve() that starts at a multiple of `alignment`. mmap only aligns to the base page
+ * size, so this reserves `alignment` bytes more and unmaps the excess on both sides again.
+ */
+auto ReserveAligned(size_t size, size_t alignment) -> void * {
+  auto *memory = static_cast<char *>(Reserve(size + alignment));
+  auto *aligned = reinterpret_cast<char *>(RoundUp(reinterpret_cast<uintptr_t>(memory), alignment));
+  if (aligned != memory) {
+    munmap(memory, aligned - memory);
+  }
+  munmap(aligned + size, memory + alignment - aligned);
+  return aligned;
+}
+
+}  // namespace
+
 BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
-                                     LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
-  // TODO(students): remove this line after you have implemented the buffer pool manager
-  throw NotImplementedException(
-      "BufferPoolManager is not implemented yet. If you have finished implementing BPM, please remove the throw "
-      "exception line in `buffer_pool_manager.cpp`.");
+                                     LogManager *log_manager, size_t num_instances, ReplacerType replacer_type)
+    : pool_size_(pool_size),
+      max_pool_size_(std::max<size_t>(pool_size, BUFFER_POOL_MAX_SIZE)),
+      page_size_(disk_manager->GetPageSize()),
+      disk_scheduler_(std::make_unique<DiskScheduler>(disk_manager)) {
+  BUSTUB_ASSERT(pool_size > 0, "buffer pool must have at least one frame");
+  num_instances = std::clamp<size_t>(num_instances, 1, pool_size);
 
-  // we allocate a consecutive memory space for the buffer pool
-  pages_ = new Page[pool_size_];
-  replacer_ = std::make_unique<LRUKReplacer>(pool_size, replacer_k);
+  // The frame data is one anonymous mapping: the kernel hands out zeroed memory lazily, so even a large pool is
+  // constructed without touching it, and whole huge pages keep the TLB footprint of the pool small. Address space is
+  // reserved for the largest pool, so growing never moves a frame.
+  frame_arena_size_ = RoundUp(max_pool_size_ * page_size_, BUSTUB_HUGE_PAGE_SIZE);
+  frame_arena_ = static_cast<char *>(ReserveAligned(frame_arena_size_, BUSTUB_HUGE_PAGE_SIZE));
+#ifdef MADV_HUGEPAGE
+  // Only a hint; the pool works the same when transparent huge pages are disabled. The kernel only backs whole,
+  // aligned huge pages, which is why the arena starts on a huge page boundary.
+  madvise(frame_arena_, frame_arena_size_, MADV_HUGEPAGE);
+#endif
+  pages_size_ = RoundUp(max_pool_size_ * sizeof(Page), BUSTUB_PAGE_ALIGNMENT);
+  pages_ = static_cast<Page *>(Reserve(pages_size_));
+  CommitFrames(0, pool_size_);
 
-  // Initially, every page is in the free list.
-  for (size_t i = 0; i < pool_size_; ++i) {
-    free_list_.emplace_back(static_cast<int>(i));
+  for (size_t i = 0; i < num_instances; ++i) {
+    instances_.emplace_back(std::make_unique<BufferPoolManagerInstance>(
+        GetInstanceSize(i, num_instances, pool_size_), pages_, static_cast<uint32_t>(num_instances),
+        static_cast<uint32_t>(i), disk_scheduler_.get(), replacer_k, log_manager, replacer_type));
   }
+
+  SetReadAheadWindow(READ_AHEAD_WINDOW);
+  SetScanRingSize(SCAN_RING_SIZE);
 }
 
-BufferPoolManager::~BufferPoolManager() { delete[] pages_; }
+BufferPoolManager::~BufferPoolManager() {
+  StopPageCleaner();
+  {
+    std::scoped_lock lock(read_ahead_latch_);
+    stop_read_ahead_ = true;
+  }
+  read_ahead_cv_.notify_all();
+  if (read_ahead_thread_.joinable()) {
+    read_ahead_thread_.join();
+  }
+  instances_.clear();
+  DecommitFrames(0, pool_size_);
+  munmap(pages_, pages_size_);
+  munmap(frame_arena_, frame_arena_size_);
+}
+
+void BufferPoolManager::CommitFrames(size_t from, size_t to) {
+  // Committing a range that overlaps already accessible memory is harmless, so round outwards.
+  auto *data = frame_arena_ + RoundDown(from * page_size_, BUSTUB_PAGE_ALIGNMENT);
+  auto *metadata = reinterpret_cast<char *>(pages_) + RoundDown(from * sizeof(Page), BUSTUB_PAGE_ALIGNMENT);
+  if (mprotect(data, frame_arena_ + RoundUp(to * page_size_, BUSTUB_PAGE_ALIGNMENT) - data,
+               PROT_READ | PROT_WRITE) != 0 ||
+      mprotect(metadata,
+               reinterpret_cast<char *>(pages_) + RoundUp(to * sizeof(Page), BUSTUB_PAGE_ALIGNMENT) - metadata,
+               PROT_READ | PROT_WRITE) != 0) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot commit the buffer pool frames");
+  }
+  for (size_t i = from; i < to; ++i) {
+    auto *page = new (&pages_[i]) Page();
+    page->data_ = frame_arena_ + i * page_size_;
+    page->page_size_ = page_size_;
+  }
+}
+
+void BufferPoolManager::DecommitFrames(size_t from, size_t to) {
+  for (size_t i = from; i < to; ++i) {
+    pages_[i].~Page();
+  }
+  // Only memory no remaining frame shares a system page with is given back.
+  auto release = [](char *base, size_t begin, size_t end) {
+    begin = RoundUp(begin, BUSTUB_PAGE_ALIGNMENT);
+    end = RoundUp(end, BUSTUB_PAGE_ALIGNMENT);
+    if (begin < end) {
+      madvise(base + begin, end - begin, MADV_DONTNEED);
+      mprotect(base + begin, end - begin, PROT_NONE);
+    }
+  };
+  release(frame_arena_, from * page_size_, to * page_size_);
+  release(reinterpret_cast<char *>(pages_), from * sizeof(Page), to * sizeof(Page));
+}
 
-auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * { return nullptr; }
+auto BufferPoolManager::ResizePool(size_t pool_size, std::chrono::milliseconds timeout) -> bool {
+  if (pool_size < instances_.size() || pool_size > max_pool_size_) {
+    return false;
+  }
+  std::scoped_lock lock(resize_latch_);
+  const size_t old_pool_size = pool_size_;
+  if (pool_size > old_pool_size) {
+    CommitFrames(old_pool_size, pool_size);
+    for (size_t i = 0; i < instances_.size(); ++i) {
+      instances_[i]->Resize(GetInstanceSize(i, instances_.size(), pool_size));
+    }
+  } else if (pool_size < old_pool_size) {
+    for (size_t i = 0; i < instances_.size(); ++i) {
+      instances_[i]->Resize(GetInstanceSize(i, instances_.size(), pool_size));
+    }
+    // Frames that were pinned are let go by their last UnpinPage; wait for that before releasing their memory.
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (auto &instance : instances_) {
+      while (instance->DrainFrames() > 0) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+          // Hand the frames back instead of waiting for a pin that may never be released.
+          for (size_t i = 0; i < instances_.size(); ++i) {
+            instances_[i]->Resize(GetInstanceSize(i, instances_.size(), old_pool_size));
+          }
+          ApplyScanSettings();
+          return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+    DecommitFrames(pool_size, old_pool_size);
+  }
+  pool_size_ = pool_size;
+  ApplyScanSettings();
+  return true;
+}
 
-auto BufferPoolManager::FetchPage(page_id_t page_id, [[maybe_unused]] AccessType access_type) -> Page * {
+auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
+  size_t start = next_instance_.fetch_add(1) % instances_.size();
+  for (size_t i = 0; i < instances_.size(); ++i) {
+    auto *page = instances_[(start + i) % instances_.size()]->NewPage(page_id);
+    if (page != nullptr) {
+      return page;
+    }
+  }
   return nullptr;
 }
 
-auto BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, [[maybe_unused]] AccessType access_type) -> bool {
-  return false;
+auto BufferPoolManager::FetchPage(page_id_t page_id, AccessType access_type) -> Page * {
+  if (page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  return GetInstance(page_id)->FetchPage(page_id, access_type);
+}
+
+auto BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, AccessType access_type) -> bool {
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  return GetInstance(page_id)->UnpinPage(page_id, is_dirty, access_type);
+}
+
+auto BufferPoolManager::FlushPage(page_id_t page_id) -> bool {
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  return GetInstance(page_id)->FlushPage(page_id);
+}
+
+void BufferPoolManager::FlushAllPages() {
+  // Page ids are striped across the instances, so runs of consecutive page ids only form once the pages of every
+  // instance are collected. Each latch is only held while its instance collects; the writes run without any.
+  FlushBatch batch;
+  for (auto &instance : instances_) {
+    instance->BeginFlushAll(&batch);
+  }
+  for (const auto &io : batch.previous_io_) {
+    io.wait();
+  }
+  disk_scheduler_->WritePages(std::move(batch.pages_));
+  for (auto &flushed : batch.flushed_) {
+    flushed.set_value(true);
+  }
+  // Deleted pages are only recorded in memory until here.
+  disk_scheduler_->GetDiskManager()->SyncFreePageMap();
+}
+
+auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool {
+  if (page_id == INVALID_PAGE_ID) {
+    return true;
+  }
+  return GetInstance(page_id)->DeletePage(page_id);
+}
+
+void BufferPoolManager::SetReadAheadWindow(size_t window) {
+  {
+    std::scoped_lock lock(read_ahead_latch_);
+    requested_read_ahead_window_ = window;
+    read_ahead_streams_.fill(ReadAheadStream{});
+    read_ahead_queue_.clear();
+  }
+  ApplyReadAheadWindow(window);
+}
+
+void BufferPoolManager::ApplyReadAheadWindow(size_t window) {
+  size_t max_prefetched = 0;
+  for (auto &instance : instances_) {
+    instance->SetMaxPrefetched(window);
+    max_prefetched += instance->GetMaxPrefetched();
+  }
+
+  std::scoped_lock lock(read_ahead_latch_);
+  read_ahead_window_ = std::min(window, max_prefetched);
+  if (read_ahead_window_ > 0 && !read_ahead_thread_.joinable()) {
+    read_ahead_thread_ = std::thread(&BufferPoolManager::ReadAheadWorker, this);
+  }
+}
+
+void BufferPoolManager::ApplyScanSettings() {
+  size_t window;
+  {
+    std::scoped_lock lock(read_ahead_latch_);
+    window = requested_read_ahead_window_;
+  }
+  ApplyReadAheadWindow(window);
+  ApplyScanRingSize(requested_scan_ring_size_);
+}
+
+auto BufferPoolManager::GetReadAheadWindow() -> size_t {
+  std::scoped_lock lock(read_ahead_latch_);
+  return read_ahead_window_;
+}
+
+void BufferPoolManager::SetScanRingSize(size_t scan_ring_size) {
+  requested_scan_ring_size_ = scan_ring_size;
+  ApplyScanRingSize(scan_ring_size);
+}
+
+void BufferPoolManager::ApplyScanRingSize(size_t scan_ring_size) {
+  const size_t per_instance = (scan_ring_size + instances_.size() - 1) / instances_.size();
+  for (auto &instance : instances_) {
+    instance->SetScanRingSize(per_instance);
+  }
+}
+
+auto BufferPoolManager::GetScanRingSize() -> size_t {
+  size_t scan_ring_size = 0;
+  for (auto &instance : instances_) {
+    scan_ring_size += instance->GetScanRingSize();
+  }
+  return scan_ring_size;
+}
+
+void BufferPoolManager::StartPageCleaner(size_t clean_frame_percent) {
+  std::scoped_lock lock(page_cleaner_latch_);
+  if (page_cleaner_thread_.joinable()) {
+    return;
+  }
+  stop_page_cleaner_ = false;
+  page_cleaner_thread_ = std::thread(&BufferPoolManager::PageCleanerWorker, this, clean_frame_percent);
+}
+
+void BufferPoolManager::StopPageCleaner() {
+  std::thread page_cleaner_thread;
+  {
+    std::scoped_lock lock(page_cleaner_latch_);
+    stop_page_cleaner_ = true;
+    page_cleaner_thread = std::move(page_cleaner_thread_);
+  }
+  page_cleaner_cv_.notify_all();
+  if (page_cleaner_thread.joinable()) {
+    page_cleaner_thread.join();
+  }
+}
+
+auto BufferPoolManager::CleanFrames(size_t clean_frame_percent) -> size_t {
+  size_t written = 0;
+  for (auto &instance : instances_) {
+    written += instance->CleanFrames((instance->GetPoolSize() * clean_frame_percent + 99) / 100);
+  }
+  cleaner_write_backs_ += written;
+  return written;
+}
+
+auto BufferPoolManager::GetForegroundWriteBacks() -> size_t {
+  size_t write_backs = 0;
+  for (auto &instance : instances_) {
+    write_backs += instance->GetForegroundWriteBacks();
+  }
+  return write_backs;
 }
 
-auto BufferPoolManager::FlushPage(page_id_t page_id) -> bool { return false; }
+auto BufferPoolManager::GetStats() -> BufferPoolStatsSnapshot {
+  BufferPoolStatsSnapshot stats;
+  for (auto &instance : instances_) {
+    stats.Merge(instance->GetStats());
+  }
+  return stats;
+}
 
-void BufferPoolManager::FlushAllPages() {}
+void BufferPoolManager::PageCleanerWorker(size_t clean_frame_percent) {
+  std::unique_lock lock(page_cleaner_latch_);
+  while (!page_cleaner_cv_.wait_for(lock, page_cleaner_interval, [this] { return stop_page_cleaner_; })) {
+    lock.unlock();
+    CleanFrames(clean_frame_percent);
+    lock.lock();
+  }
+}
 
-auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool { return false; }
+void BufferPoolManager::ReadAheadHint(page_id_t page_id, page_id_t next_page_id, NextPageIdFn next_of) {
+  std::scoped_lock lock(read_ahead_latch_);
+  if (read_ahead_window_ == 0 || page_id == INVALID_PAGE_ID) {
+    return;
+  }
 
-auto BufferPoolManager::AllocatePage() -> page_id_t { return next_page_id_++; }
+  auto stream = std::find_if(read_ahead_streams_.begin(), read_ahead_streams_.end(),
+                             [page_id](const auto &s) { return s.generation_ != 0 && s.last_page_id_ == page_id; });
+  if (stream != read_ahead_streams_.end()) {
+    // Scans hint once per tuple; only moving on to the next page advances the stream.
+    return;
+  }
+  stream = std::find_if(read_ahead_streams_.begin(), read_ahead_streams_.end(), [page_id](const auto &s) {
+    return s.generation_ != 0 && std::find(s.ahead_.begin(), s.ahead_.end(), page_id) != s.ahead_.end();
+  });
+  if (stream == read_ahead_streams_.end()) {
+    // A scan that is not followed yet, or one that got ahead of its read-ahead: start over from where it is.
+    stream = read_ahead_streams_.begin() + next_stream_;
+    next_stream_ = (next_stream_ + 1) % READ_AHEAD_STREAMS;
+    *stream = ReadAheadStream{};
+    stream->generation_ = ++last_generation_;
+    stream->next_of_ = next_of;
+  } else {
+    while (stream->ahead_.front() != page_id) {
+      stream->ahead_.pop_front();
+    }
+    stream->ahead_.pop_front();
+  }
+  stream->last_page_id_ = page_id;
+  if (stream->in_flight_) {
+    return;
+  }
 
-auto BufferPoolManager::FetchPageBasic(page_id_t page_id) -> BasicPageGuard { return {this, nullptr}; }
+  // Without next_of the chain cannot be followed past the hinted page.
+  const size_t window = next_of == nullptr ? 1 : read_ahead_window_;
+  const auto index = static_cast<size_t>(stream - read_ahead_streams_.begin());
+  if (stream->ahead_.empty()) {
+    QueueReadAhead(index, next_page_id, window);
+  } else if (stream->ahead_.size() <= window / 2) {
+    QueueReadAhead(index, stream->resume_page_id_, window - stream->ahead_.size());
+  }
+}
 
-auto BufferPoolManager::FetchPageRead(page_id_t page_id) -> ReadPageGuard { return {this, nullptr}; }
+void BufferPoolManager::QueueReadAhead(size_t stream, page_id_t page_id, size_t count) {
+  if (page_id == INVALID_PAGE_ID || count == 0) {
+    return;
+  }
+  read_ahead_streams_[stream].in_flight_ = true;
+  read_ahead_queue_.push_back({stream, read_ahead_streams_[stream].generation_, page_id, count});
+  read_ahead_cv_.notify_one();
+}
 
-auto BufferPoolManager::FetchPageWrite(page_id_t page_id) -> WritePageGuard { return {this, nullptr}; }
+void BufferPoolManager::ReadAheadWorker() {
+  std::unique_lock lock(read_ahead_latch_);
+  while (true) {
+    read_ahead_cv_.wait(lock, [this] { return stop_read_ahead_ || !read_ahead_queue_.empty(); });
+    if (stop_read_ahead_) {
+      return;
+    }
+    auto request = read_ahead_queue_.front();
+    read_ahead_queue_.pop_front();
+    if (read_ahead_streams_[request.stream_].generation_ != request.generation_) {
+      continue;
+    }
+    auto next_of = read_ahead_streams_[request.stream_].next_of_;
+    lock.unlock();
+    page_id_t next_page_id = INVALID_PAGE_ID;
+    bool read = GetInstance(request.page_id_)->PrefetchPage(request.page_id_, next_of, &next_page_id);
+    lock.lock();
+
+    auto &stream = read_ahead_streams_[request.stream_];
+    if (stream.generation_ != request.generation_) {
+      continue;
+    }
+    // A page that was cached already is not read, so where its chain continues is only known once the scan gets
+    // there and hints it.
+    stream.ahead_.push_back(request.page_id_);
+    stream.resume_page_id_ = read ? next_page_id : INVALID_PAGE_ID;
+    stream.in_flight_ = false;
+    if (read && request.count_ > 1) {
+      QueueReadAhead(request.stream_, next_page_id, request.count_ - 1);
+    }
+  }
+}
+
+auto BufferPoolManager::FetchPageBasic(page_id_t page_id) -> BasicPageGuard { return {this, FetchPage(page_id)}; }
+
+auto BufferPoolManager::FetchPageRead(page_id_t page_id) -> ReadPageGuard {
+  auto *page = FetchPage(page_id);
+  if (page != nullptr) {
+    page->RLatch();
+  }
+  return {this, page};
+}
+
+auto BufferPoolManager::FetchPageWrite(page_id_t page_id) -> WritePageGuard {
+  auto *page = FetchPage(page_id);
+  if (page != nullptr) {
+    page->WLatch();
+  }
+  return {this, page};
+}
+
+auto BufferPoolManager::FetchPageOptimistic(page_id_t page_id) -> ReadPageGuard {
+  auto *page = FetchPage(page_id);
+  return {this, page, true};
+}
 
-auto BufferPoolManager::NewPageGuarded(page_id_t *page_id) -> BasicPageGuard { return {this, nullptr}; }
+auto BufferPoolManager::NewPageGuarded(page_id_t *page_id) -> BasicPageGuard { return {this, NewPage(page_id)}; }
 
 }  // namespace bustub
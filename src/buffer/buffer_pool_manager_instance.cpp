@@ -0,0 +1,581 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_manager_instance.cpp
+//
+// Identification: src/buffer/buffer_pool_manager_instance.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_manager_instance.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+
+#include "common/exception.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, Page *pages, uint32_t num_instances,
+                                                     uint32_t instance_index, DiskScheduler *disk_scheduler,
+                                                     size_t replacer_k, LogManager *log_manager,
+                                                     ReplacerType replacer_type)
+    : pool_size_(pool_size),
+      num_frames_(pool_size),
+      num_instances_(num_instances),
+      instance_index_(instance_index),
+      next_page_id_(INVALID_PAGE_ID),
+      pages_(pages),
+      disk_scheduler_(disk_scheduler),
+      log_manager_(log_manager),
+      is_prefetched_(pool_size, false),
+      in_scan_ring_(pool_size, false),
+      pending_io_(pool_size),
+      pending_load_(pool_size) {
+  BUSTUB_ASSERT(num_instances > 0, "a buffer pool has at least one instance");
+  BUSTUB_ASSERT(instance_index < num_instances, "instance index out of range");
+  replacer_ = Replacer::Create(replacer_type, pool_size, replacer_k);
+
+  // Continue after the pages of an existing database file, with the first id that belongs to this instance.
+  auto num_pages = static_cast<uint32_t>(disk_scheduler_->GetDiskManager()->GetNumPages());
+  next_page_id_ = static_cast<page_id_t>(num_pages + (instance_index + num_instances - num_pages % num_instances) %
+                                                         num_instances);
+
+  // Initially, every frame is in the free list.
+  for (size_t i = 0; i < pool_size_; ++i) {
+    free_list_.emplace_back(static_cast<frame_id_t>(i));
+  }
+}
+
+auto BufferPoolManagerInstance::AcquireFrame(frame_id_t *frame_id) -> bool {
+  if (!free_list_.empty()) {
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
+    return true;
+  }
+  if (!replacer_->Evict(frame_id)) {
+    // Prefetched pages that nobody asked for yet are the last resort; they are never dirty.
+    if (prefetched_.empty()) {
+      stats_.RecordPinWait();
+      return false;
+    }
+    *frame_id = prefetched_.front();
+    prefetched_.pop_front();
+    is_prefetched_[*frame_id] = false;
+  }
+  LeaveScanRing(*frame_id);
+  stats_.RecordEviction();
+  auto *victim = GetFrame(*frame_id);
+  if (victim->IsDirty()) {
+    ScheduleWriteBack(*frame_id);
+    stats_.RecordDirtyWriteBack();
+  }
+  page_table_.erase(victim->GetPageId());
+  return true;
+}
+
+void BufferPoolManagerInstance::ScheduleWriteBack(frame_id_t frame_id) {
+  auto *page = GetFrame(frame_id);
+  // Only the last I/O of a frame is remembered. A write of the same page that is still running may belong to a
+  // FlushAllPages batch on another worker, which must not read the frame once it is reused, so let it finish. This
+  // only happens for a page that was dirtied again while the batch was being written.
+  if (HasPendingIO(frame_id)) {
+    pending_io_[frame_id].wait();
+  }
+  pending_io_[frame_id] = disk_scheduler_->ScheduleWrite(page->GetPageId(), page->GetData()).share();
+  page->is_dirty_ = false;
+}
+
+auto BufferPoolManagerInstance::HasPendingIO(frame_id_t frame_id) const -> bool {
+  const auto &io = pending_io_[frame_id];
+  return io.valid() && io.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+auto BufferPoolManagerInstance::BeginLoad(frame_id_t frame_id, std::promise<bool> *loaded) -> std::shared_future<bool> {
+  auto previous_io = std::move(pending_io_[frame_id]);
+  pending_io_[frame_id] = loaded->get_future().share();
+  pending_load_[frame_id] = pending_io_[frame_id];
+  return previous_io;
+}
+
+auto BufferPoolManagerInstance::NewPage(page_id_t *page_id) -> Page * {
+  std::unique_lock lock(latch_);
+  frame_id_t frame_id;
+  if (!AcquireFrame(&frame_id)) {
+    return nullptr;
+  }
+  bool reused = false;
+  *page_id = AllocatePage(&reused);
+  if (auto stale = page_table_.find(*page_id); stale != page_table_.end()) {
+    // Read-ahead may have loaded the id while it was deallocated; that copy is garbage now that the id is reused.
+    frame_id_t stale_frame = stale->second;
+    page_table_.erase(stale);
+    if (!ForgetPrefetched(stale_frame)) {
+      replacer_->Remove(stale_frame);
+    }
+    LeaveScanRing(stale_frame);
+    GetFrame(stale_frame)->page_id_ = INVALID_PAGE_ID;
+    if (static_cast<size_t>(stale_frame) < pool_size_) {
+      free_list_.push_back(stale_frame);
+    }
+  }
+
+  auto *page = GetFrame(frame_id);
+  page->page_id_ = *page_id;
+  page->pin_count_ = 1;
+  page->is_dirty_ = false;
+  page_table_.emplace(*page_id, frame_id);
+
+  replacer_->RecordAccess(frame_id, AccessType::Unknown, *page_id);
+  replacer_->SetEvictable(frame_id, false);
+  std::promise<bool> loaded;
+  auto previous_io = BeginLoad(frame_id, &loaded);
+  lock.unlock();
+  if (reused) {
+    // Anything written to the page must not outlive the free-page map still listing it as free after a crash.
+    disk_scheduler_->GetDiskManager()->SyncFreePageMap();
+  }
+  // The frame's memory is reused once the write-back of its previous page is done.
+  if (previous_io.valid()) {
+    previous_io.wait();
+  }
+  page->ResetMemory();
+  loaded.set_value(true);
+  return page;
+}
+
+auto BufferPoolManagerInstance::FetchPage(page_id_t page_id, AccessType access_type) -> Page * {
+  std::unique_lock lock(latch_);
+  const bool use_ring = access_type == AccessType::Scan && scan_ring_size_ > 0;
+  auto it = page_table_.find(page_id);
+  if (it != page_table_.end() && static_cast<size_t>(it->second) >= pool_size_) {
+    // A shrink is waiting for this frame, and pinning it again would keep it from ever draining. Wait until the frame
+    // is let go and read the page into a live frame instead. The wait is bounded since the caller may hold a pin on
+    // the page itself; after that the frame is pinned like any other.
+    frame_retired_.wait_for(lock, std::chrono::milliseconds(RETIRING_FRAME_WAIT_MS), [&] {
+      it = page_table_.find(page_id);
+      return it == page_table_.end() || static_cast<size_t>(it->second) < pool_size_;
+    });
+  }
+  if (it != page_table_.end()) {
+    const frame_id_t frame_id = it->second;
+    auto *page = GetFrame(frame_id);
+    stats_.RecordHit();
+    bool record_hit = false;
+    if (ForgetPrefetched(frame_id)) {
+      // The first access brings the frame into the replacer.
+      replacer_->RecordAccess(frame_id, access_type, page_id);
+      if (use_ring) {
+        AdmitToScanRing(frame_id);
+      }
+    } else if (!use_ring) {
+      // A point access promotes a page out of the scan ring into the regular replacer population.
+      LeaveScanRing(frame_id);
+      record_hit = true;
+    }
+    // A scan revisiting a page neither heats up a ring page nor a page of the working set. A page that is pinned
+    // already is not evictable, and an unpinned one must be marked before the latch is released, or Evict could pick
+    // it while it is in use.
+    if (page->pin_count_++ == 0) {
+      replacer_->SetEvictable(frame_id, false);
+    }
+    // Another thread may still be reading the page in; wait for it rather than reading it a second time.
+    auto load = pending_load_[frame_id];
+    lock.unlock();
+    // The page stays pinned, so the frame cannot leave the replacer before the hit is recorded.
+    if (record_hit) {
+      replacer_->RecordHit(frame_id, access_type, page_id);
+    }
+    if (load.valid()) {
+      load.wait();
+    }
+    return page;
+  }
+
+  frame_id_t frame_id;
+  if (!(use_ring && scan_ring_.size() >= scan_ring_size_ && RecycleScanFrame(&frame_id)) &&
+      !AcquireFrame(&frame_id)) {
+    return nullptr;
+  }
+  stats_.RecordMiss();
+  auto *page = GetFrame(frame_id);
+  page->page_id_ = page_id;
+  page->pin_count_ = 1;
+  page->is_dirty_ = false;
+  page_table_.emplace(page_id, frame_id);
+
+  replacer_->RecordAccess(frame_id, access_type, page_id);
+  replacer_->SetEvictable(frame_id, false);
+  if (use_ring) {
+    AdmitToScanRing(frame_id);
+  }
+  std::promise<bool> loaded;
+  auto previous_io = BeginLoad(frame_id, &loaded);
+  lock.unlock();
+  // The read is scheduled after any write-back of the page, so it sees the latest version.
+  if (previous_io.valid()) {
+    previous_io.wait();
+  }
+  page->ResetMemory();
+  disk_scheduler_->ReadPage(page_id, page->GetData());
+  loaded.set_value(true);
+  return page;
+}
+
+auto BufferPoolManagerInstance::UnpinPage(page_id_t page_id, bool is_dirty, [[maybe_unused]] AccessType access_type)
+    -> bool {
+  std::scoped_lock lock(latch_);
+  auto it = page_table_.find(page_id);
+  if (it == page_table_.end()) {
+    return false;
+  }
+  auto *page = GetFrame(it->second);
+  if (page->GetPinCount() <= 0) {
+    return false;
+  }
+  page->is_dirty_ |= is_dirty;
+  if (--page->pin_count_ == 0) {
+    replacer_->SetEvictable(it->second, true);
+    if (static_cast<size_t>(it->second) >= pool_size_) {
+      // The pool shrank while the page was pinned; let the frame go now that nobody uses it.
+      RetireFrame(it->second);
+    }
+  }
+  return true;
+}
+
+auto BufferPoolManagerInstance::FlushPage(page_id_t page_id) -> bool {
+  std::unique_lock lock(latch_);
+  while (true) {
+    auto it = page_table_.find(page_id);
+    if (it == page_table_.end()) {
+      return false;
+    }
+    const frame_id_t frame_id = it->second;
+    // A page that is still being read in cannot be written yet.
+    if (HasPendingIO(frame_id)) {
+      auto io = pending_io_[frame_id];
+      lock.unlock();
+      io.wait();
+      lock.lock();
+      continue;
+    }
+    ScheduleWriteBack(frame_id);
+    auto write = pending_io_[frame_id];
+    lock.unlock();
+    write.wait();
+    return true;
+  }
+}
+
+void BufferPoolManagerInstance::FlushAllPages() {
+  FlushBatch batch;
+  BeginFlushAll(&batch);
+  for (const auto &io : batch.previous_io_) {
+    io.wait();
+  }
+  disk_scheduler_->WritePages(std::move(batch.pages_));
+  for (auto &flushed : batch.flushed_) {
+    flushed.set_value(true);
+  }
+  // Deleted pages are only recorded in memory until here.
+  disk_scheduler_->GetDiskManager()->SyncFreePageMap();
+}
+
+void BufferPoolManagerInstance::BeginFlushAll(FlushBatch *batch) {
+  std::scoped_lock lock(latch_);
+  for (const auto &[page_id, frame_id] : page_table_) {
+    // A clean page, including one that is still being read in, matches the disk already.
+    auto *page = GetFrame(frame_id);
+    if (!page->IsDirty()) {
+      continue;
+    }
+    // The batch may write the page on another worker than its own, so a write still running on the page's worker
+    // has to finish before the batch writes the page.
+    if (pending_io_[frame_id].valid()) {
+      batch->previous_io_.push_back(pending_io_[frame_id]);
+    }
+    batch->pages_.emplace_back(page_id, page->GetData());
+    pending_io_[frame_id] = batch->flushed_.emplace_back().get_future().share();
+    page->is_dirty_ = false;
+  }
+}
+
+auto BufferPoolManagerInstance::DeletePage(page_id_t page_id) -> bool {
+  std::scoped_lock lock(latch_);
+  auto it = page_table_.find(page_id);
+  if (it == page_table_.end()) {
+    DeallocatePage(page_id);
+    return true;
+  }
+  frame_id_t frame_id = it->second;
+  auto *page = GetFrame(frame_id);
+  if (page->GetPinCount() > 0) {
+    return false;
+  }
+  page_table_.erase(it);
+  if (!ForgetPrefetched(frame_id)) {
+    replacer_->Remove(frame_id);
+  }
+  LeaveScanRing(frame_id);
+  if (static_cast<size_t>(frame_id) < pool_size_) {
+    free_list_.push_back(frame_id);
+  }
+
+  page->ResetMemory();
+  page->page_id_ = INVALID_PAGE_ID;
+  page->pin_count_ = 0;
+  page->is_dirty_ = false;
+  DeallocatePage(page_id);
+  return true;
+}
+
+auto BufferPoolManagerInstance::PrefetchPage(page_id_t page_id, NextPageIdFn next_of, page_id_t *next_page_id)
+    -> bool {
+  std::unique_lock lock(latch_);
+  if (page_id >= next_page_id_ || page_table_.count(page_id) > 0 || max_prefetched_ == 0) {
+    return false;
+  }
+
+  frame_id_t frame_id;
+  if (prefetched_.size() >= max_prefetched_) {
+    // Recycle the oldest unused prefetch rather than pushing a page with real access history out of the pool.
+    frame_id = prefetched_.front();
+    prefetched_.pop_front();
+    is_prefetched_[frame_id] = false;
+    page_table_.erase(GetFrame(frame_id)->GetPageId());
+  } else if (!AcquireFrame(&frame_id)) {
+    return false;
+  }
+
+  auto *page = GetFrame(frame_id);
+  page->page_id_ = page_id;
+  page->pin_count_ = 0;
+  page->is_dirty_ = false;
+  page_table_.emplace(page_id, frame_id);
+  prefetched_.push_back(frame_id);
+  is_prefetched_[frame_id] = true;
+  std::promise<bool> loaded;
+  auto previous_io = BeginLoad(frame_id, &loaded);
+  lock.unlock();
+  if (previous_io.valid()) {
+    previous_io.wait();
+  }
+  page->ResetMemory();
+  disk_scheduler_->ReadPage(page_id, page->GetData());
+  if (next_of != nullptr) {
+    *next_page_id = next_of(page->GetData());
+  }
+  loaded.set_value(true);
+  return true;
+}
+
+void BufferPoolManagerInstance::SetMaxPrefetched(size_t max_prefetched) {
+  std::scoped_lock lock(latch_);
+  max_prefetched_ = std::min(max_prefetched, std::max<size_t>(pool_size_ / 4, 1));
+}
+
+auto BufferPoolManagerInstance::GetMaxPrefetched() -> size_t {
+  std::scoped_lock lock(latch_);
+  return max_prefetched_;
+}
+
+auto BufferPoolManagerInstance::ForgetPrefetched(frame_id_t frame_id) -> bool {
+  if (!is_prefetched_[frame_id]) {
+    return false;
+  }
+  prefetched_.remove(frame_id);
+  is_prefetched_[frame_id] = false;
+  return true;
+}
+
+void BufferPoolManagerInstance::SetScanRingSize(size_t scan_ring_size) {
+  std::scoped_lock lock(latch_);
+  scan_ring_size_ = std::min(scan_ring_size, std::max<size_t>(pool_size_ / 4, 1));
+  if (scan_ring_size_ == 0) {
+    for (auto frame_id : scan_ring_) {
+      in_scan_ring_[frame_id] = false;
+    }
+    scan_ring_.clear();
+  }
+}
+
+auto BufferPoolManagerInstance::GetScanRingSize() -> size_t {
+  std::scoped_lock lock(latch_);
+  return scan_ring_size_;
+}
+
+void BufferPoolManagerInstance::AdmitToScanRing(frame_id_t frame_id) {
+  scan_ring_.push_back(frame_id);
+  in_scan_ring_[frame_id] = true;
+  while (scan_ring_.size() > scan_ring_size_) {
+    frame_id_t recycled;
+    if (!RecycleScanFrame(&recycled)) {
+      break;
+    }
+    GetFrame(recycled)->page_id_ = INVALID_PAGE_ID;
+    free_list_.push_back(recycled);
+  }
+}
+
+auto BufferPoolManagerInstance::RecycleScanFrame(frame_id_t *frame_id) -> bool {
+  auto it = std::find_if(scan_ring_.begin(), scan_ring_.end(),
+                         [this](frame_id_t fid) { return GetFrame(fid)->GetPinCount() == 0; });
+  if (it == scan_ring_.end()) {
+    return false;
+  }
+  *frame_id = *it;
+  scan_ring_.erase(it);
+  in_scan_ring_[*frame_id] = false;
+  replacer_->Remove(*frame_id);
+  stats_.RecordEviction();
+
+  auto *victim = GetFrame(*frame_id);
+  if (victim->IsDirty()) {
+    ScheduleWriteBack(*frame_id);
+    stats_.RecordDirtyWriteBack();
+  }
+  page_table_.erase(victim->GetPageId());
+  return true;
+}
+
+void BufferPoolManagerInstance::LeaveScanRing(frame_id_t frame_id) {
+  if (in_scan_ring_[frame_id]) {
+    scan_ring_.remove(frame_id);
+    in_scan_ring_[frame_id] = false;
+  }
+}
+
+void BufferPoolManagerInstance::Resize(size_t pool_size) {
+  BUSTUB_ASSERT(pool_size > 0, "an instance needs at least one frame");
+  std::scoped_lock lock(latch_);
+  if (pool_size > pool_size_) {
+    if (pool_size > num_frames_) {
+      replacer_->Resize(pool_size);
+      is_prefetched_.resize(pool_size, false);
+      in_scan_ring_.resize(pool_size, false);
+      pending_io_.resize(pool_size);
+      pending_load_.resize(pool_size);
+    }
+    for (size_t i = pool_size_; i < pool_size; ++i) {
+      // A frame a shrink has not drained yet keeps its pinned page and simply becomes live again.
+      if (i >= num_frames_ || GetFrame(static_cast<frame_id_t>(i))->GetPageId() == INVALID_PAGE_ID) {
+        free_list_.emplace_back(static_cast<frame_id_t>(i));
+      }
+    }
+    num_frames_ = std::max(num_frames_, pool_size);
+  } else {
+    BUSTUB_ASSERT(num_frames_ == pool_size_, "the previous shrink has not been drained");
+    free_list_.remove_if([pool_size](frame_id_t frame_id) { return static_cast<size_t>(frame_id) >= pool_size; });
+  }
+  pool_size_ = pool_size;
+  for (size_t i = pool_size; i < num_frames_; ++i) {
+    auto *page = GetFrame(static_cast<frame_id_t>(i));
+    if (page->GetPageId() != INVALID_PAGE_ID && page->GetPinCount() == 0) {
+      RetireFrame(static_cast<frame_id_t>(i));
+    }
+  }
+  max_prefetched_ = std::min(max_prefetched_, std::max<size_t>(pool_size / 4, 1));
+  scan_ring_size_ = std::min(scan_ring_size_, std::max<size_t>(pool_size / 4, 1));
+}
+
+auto BufferPoolManagerInstance::DrainFrames() -> size_t {
+  std::scoped_lock lock(latch_);
+  size_t pinned = 0;
+  for (size_t i = pool_size_; i < num_frames_; ++i) {
+    if (GetFrame(static_cast<frame_id_t>(i))->GetPageId() != INVALID_PAGE_ID ||
+        HasPendingIO(static_cast<frame_id_t>(i))) {
+      pinned++;
+    }
+  }
+  if (pinned == 0 && num_frames_ > pool_size_) {
+    num_frames_ = pool_size_;
+    replacer_->Resize(num_frames_);
+    is_prefetched_.resize(num_frames_);
+    in_scan_ring_.resize(num_frames_);
+    pending_io_.resize(num_frames_);
+    pending_load_.resize(num_frames_);
+  }
+  return pinned;
+}
+
+void BufferPoolManagerInstance::RetireFrame(frame_id_t frame_id) {
+  auto *page = GetFrame(frame_id);
+  if (!ForgetPrefetched(frame_id)) {
+    replacer_->Remove(frame_id);
+  }
+  LeaveScanRing(frame_id);
+  stats_.RecordEviction();
+  if (page->IsDirty()) {
+    ScheduleWriteBack(frame_id);
+    stats_.RecordDirtyWriteBack();
+  }
+  page_table_.erase(page->GetPageId());
+  page->page_id_ = INVALID_PAGE_ID;
+  page->is_dirty_ = false;
+  frame_retired_.notify_all();
+}
+
+auto BufferPoolManagerInstance::CleanFrames(size_t target_clean_frames) -> size_t {
+  std::vector<std::pair<frame_id_t, page_id_t>> candidates;
+  {
+    std::scoped_lock lock(latch_);
+    size_t clean_frames = free_list_.size();
+    for (size_t i = 0; i < pool_size_; ++i) {
+      const auto frame_id = static_cast<frame_id_t>((cleaner_hand_ + i) % pool_size_);
+      auto *page = GetFrame(frame_id);
+      if (page->GetPageId() == INVALID_PAGE_ID || page->GetPinCount() > 0) {
+        continue;
+      }
+      if (page->IsDirty()) {
+        candidates.emplace_back(frame_id, page->GetPageId());
+      } else {
+        clean_frames++;
+      }
+    }
+    if (clean_frames >= target_clean_frames) {
+      return 0;
+    }
+    candidates.resize(std::min(candidates.size(), target_clean_frames - clean_frames));
+  }
+
+  std::vector<std::shared_future<bool>> writes;
+  for (const auto &[frame_id, page_id] : candidates) {
+    std::scoped_lock lock(latch_);
+    auto *page = GetFrame(frame_id);
+    // The frame may have been pinned, flushed or reused since the candidates were picked.
+    if (page->GetPageId() != page_id || page->GetPinCount() > 0 || !page->IsDirty() || !IsLogPersisted(page) ||
+        HasPendingIO(frame_id)) {
+      continue;
+    }
+    ScheduleWriteBack(frame_id);
+    writes.push_back(pending_io_[frame_id]);
+    cleaner_hand_ = (frame_id + 1) % pool_size_;
+  }
+  for (const auto &write : writes) {
+    write.wait();
+  }
+  return writes.size();
+}
+
+auto BufferPoolManagerInstance::IsLogPersisted(Page *page) -> bool {
+  return !enable_logging || log_manager_ == nullptr || page->GetLSN() <= log_manager_->GetPersistentLSN();
+}
+
+auto BufferPoolManagerInstance::AllocatePage(bool *reused) -> page_id_t {
+  auto free_page_id = disk_scheduler_->GetDiskManager()->AllocateFreePage(num_instances_, instance_index_);
+  *reused = free_page_id != INVALID_PAGE_ID;
+  if (*reused) {
+    return free_page_id;
+  }
+  const page_id_t next_page_id = next_page_id_;
+  next_page_id_ += num_instances_;
+  BUSTUB_ASSERT(next_page_id % num_instances_ == instance_index_, "allocated page id is not owned by this instance");
+  return next_page_id;
+}
+
+}  // namespace bustub
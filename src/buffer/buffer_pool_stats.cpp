@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.cpp
+//
+// Identification: src/buffer/buffer_pool_stats.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_stats.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+void BufferPoolStatsSnapshot::Merge(const BufferPoolStatsSnapshot &other) {
+  hits_ += other.hits_;
+  misses_ += other.misses_;
+  evictions_ += other.evictions_;
+  dirty_write_backs_ += other.dirty_write_backs_;
+  pin_waits_ += other.pin_waits_;
+  for (size_t i = 0; i < NUM_BUCKETS; i++) {
+    latch_wait_ns_[i] += other.latch_wait_ns_[i];
+    latch_hold_ns_[i] += other.latch_hold_ns_[i];
+  }
+}
+
+auto BufferPoolStatsSnapshot::HitRatio() const -> double {
+  auto fetches = hits_ + misses_;
+  return fetches == 0 ? 0 : static_cast<double>(hits_) / static_cast<double>(fetches);
+}
+
+auto BufferPoolStatsSnapshot::Count(const Histogram &histogram) -> uint64_t {
+  uint64_t count = 0;
+  for (auto samples : histogram) {
+    count += samples;
+  }
+  return count;
+}
+
+auto BufferPoolStatsSnapshot::Percentile(const Histogram &histogram, double percentile) -> uint64_t {
+  auto count = Count(histogram);
+  if (count == 0) {
+    return 0;
+  }
+  auto rank = static_cast<uint64_t>(static_cast<double>(count) * percentile / 100);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < NUM_BUCKETS; i++) {
+    seen += histogram[i];
+    if (seen > rank || seen == count) {
+      return uint64_t{1} << i;
+    }
+  }
+  return uint64_t{1} << (NUM_BUCKETS - 1);
+}
+
+auto BufferPoolStats::BucketOf(uint64_t ns) -> size_t {
+  size_t bucket = ns == 0 ? 0 : 64 - __builtin_clzll(ns);
+  return std::min(bucket, BufferPoolStatsSnapshot::NUM_BUCKETS - 1);
+}
+
+auto BufferPoolStats::LocalSlot() -> Slot & {
+  static std::atomic<size_t> next_slot{0};
+  thread_local const size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed) % NUM_SLOTS;
+  return slots_[slot];
+}
+
+auto BufferPoolStats::Snapshot() const -> BufferPoolStatsSnapshot {
+  BufferPoolStatsSnapshot snapshot;
+  for (const auto &slot : slots_) {
+    snapshot.hits_ += slot.hits_.load(std::memory_order_relaxed);
+    snapshot.misses_ += slot.misses_.load(std::memory_order_relaxed);
+    snapshot.evictions_ += slot.evictions_.load(std::memory_order_relaxed);
+    snapshot.dirty_write_backs_ += slot.dirty_write_backs_.load(std::memory_order_relaxed);
+    snapshot.pin_waits_ += slot.pin_waits_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < BufferPoolStatsSnapshot::NUM_BUCKETS; i++) {
+      snapshot.latch_wait_ns_[i] += slot.latch_wait_ns_[i].load(std::memory_order_relaxed);
+      snapshot.latch_hold_ns_[i] += slot.latch_hold_ns_[i].load(std::memory_order_relaxed);
+    }
+  }
+  return snapshot;
+}
+
+}  // namespace bustub
@@ -12,18 +12,109 @@
 
 #include "buffer/clock_replacer.h"
 
+#include "common/macros.h"
+
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {}
+ClockReplacer::ClockReplacer(size_t num_pages)
+    : in_replacer_(num_pages, false), evictable_(num_pages, false), referenced_(num_pages, false) {}
 
 ClockReplacer::~ClockReplacer() = default;
 
-auto ClockReplacer::Victim(frame_id_t *frame_id) -> bool { return false; }
+auto ClockReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock lock(latch_);
+  if (curr_size_ == 0) {
+    return false;
+  }
+  // The first sweep clears the reference bits it passes, so the second one is guaranteed to find a victim.
+  while (true) {
+    const auto fid = static_cast<frame_id_t>(hand_);
+    hand_ = (hand_ + 1) % in_replacer_.size();
+    if (!evictable_[fid]) {
+      continue;
+    }
+    if (referenced_[fid]) {
+      referenced_[fid] = false;
+      continue;
+    }
+    *frame_id = fid;
+    Drop(fid);
+    return true;
+  }
+}
+
+void ClockReplacer::RecordAccess(frame_id_t frame_id, [[maybe_unused]] AccessType access_type,
+                                 [[maybe_unused]] page_id_t page_id) {
+  std::scoped_lock lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < in_replacer_.size(), "invalid frame id");
+  in_replacer_[frame_id] = true;
+  referenced_[frame_id] = true;
+}
+
+void ClockReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < in_replacer_.size(), "invalid frame id");
+  std::scoped_lock lock(latch_);
+  if (!in_replacer_[frame_id] || evictable_[frame_id] == set_evictable) {
+    return;
+  }
+  evictable_[frame_id] = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
+
+void ClockReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock lock(latch_);
+  if (!in_replacer_[frame_id]) {
+    return;
+  }
+  BUSTUB_ASSERT(evictable_[frame_id], "cannot remove a non-evictable frame");
+  Drop(frame_id);
+}
+
+auto ClockReplacer::Size() -> size_t {
+  std::scoped_lock lock(latch_);
+  return curr_size_;
+}
+
+void ClockReplacer::Resize(size_t num_frames) {
+  std::scoped_lock lock(latch_);
+  in_replacer_.resize(num_frames, false);
+  evictable_.resize(num_frames, false);
+  referenced_.resize(num_frames, false);
+  if (hand_ >= num_frames) {
+    hand_ = 0;
+  }
+}
 
-void ClockReplacer::Pin(frame_id_t frame_id) {}
+void ClockReplacer::Pin(frame_id_t frame_id) {
+  std::scoped_lock lock(latch_);
+  if (in_replacer_[frame_id]) {
+    Drop(frame_id);
+  }
+}
 
-void ClockReplacer::Unpin(frame_id_t frame_id) {}
+void ClockReplacer::Unpin(frame_id_t frame_id) {
+  bool in_replacer;
+  {
+    std::scoped_lock lock(latch_);
+    in_replacer = in_replacer_[frame_id];
+  }
+  if (!in_replacer) {
+    RecordAccess(frame_id);
+  }
+  SetEvictable(frame_id, true);
+}
 
-auto ClockReplacer::Size() -> size_t { return 0; }
+void ClockReplacer::Drop(frame_id_t frame_id) {
+  in_replacer_[frame_id] = false;
+  referenced_[frame_id] = false;
+  if (evictable_[frame_id]) {
+    evictable_[frame_id] = false;
+    curr_size_--;
+  }
+}
 
 }  // namespace bustub
@@ -10,6 +10,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <functional>
+#include <thread>  // NOLINT
+
 #include "buffer/lru_k_replacer.h"
 #include "common/exception.h"
 
@@ -17,14 +20,120 @@ namespace bustub {
 
 LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
 
-auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool { return false; }
+auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock lock(latch_);
+  ApplyAccessBuffers();
+  LRUKNode *victim = nullptr;
+  for (auto &[fid, node] : node_store_) {
+    if (!node.IsEvictable()) {
+      continue;
+    }
+    if (victim == nullptr) {
+      victim = &node;
+      continue;
+    }
+    // +inf backward k-distance always wins; within the same class the least recent timestamp wins.
+    if (node.HasInfiniteDistance() != victim->HasInfiniteDistance()) {
+      if (node.HasInfiniteDistance()) {
+        victim = &node;
+      }
+      continue;
+    }
+    if (node.EarliestTimestamp() < victim->EarliestTimestamp()) {
+      victim = &node;
+    }
+  }
+  if (victim == nullptr) {
+    return false;
+  }
+  *frame_id = victim->GetFrameId();
+  node_store_.erase(*frame_id);
+  curr_size_--;
+  return true;
+}
+
+void LRUKReplacer::RecordAccess(frame_id_t frame_id, [[maybe_unused]] AccessType access_type,
+                                [[maybe_unused]] page_id_t page_id) {
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  std::scoped_lock lock(latch_);
+  auto it = node_store_.find(frame_id);
+  if (it == node_store_.end()) {
+    it = node_store_.emplace(frame_id, LRUKNode(frame_id, k_)).first;
+  }
+  it->second.RecordAccess(current_timestamp_++);
+}
+
+void LRUKReplacer::RecordHit(frame_id_t frame_id, [[maybe_unused]] AccessType access_type,
+                             [[maybe_unused]] page_id_t page_id) {
+  auto &buffer = access_buffers_[std::hash<std::thread::id>{}(std::this_thread::get_id()) % access_buffers_.size()];
+  {
+    std::scoped_lock buffer_lock(buffer.latch_);
+    buffer.accesses_.emplace_back(frame_id, current_timestamp_++);
+    if (buffer.accesses_.size() < LRUK_ACCESS_BUFFER_SIZE) {
+      return;
+    }
+  }
+  // Another thread may apply the buffer in between; then there is less or nothing left to do.
+  std::scoped_lock lock(latch_);
+  ApplyAccessBuffer(&buffer);
+}
+
+void LRUKReplacer::ApplyAccessBuffer(AccessBuffer *buffer) {
+  std::scoped_lock buffer_lock(buffer->latch_);
+  for (const auto &[frame_id, timestamp] : buffer->accesses_) {
+    // The frame is pinned from the hit until it was appended, so Evict and Remove cannot have dropped it before.
+    auto it = node_store_.find(frame_id);
+    BUSTUB_ASSERT(it != node_store_.end(), "hit on a frame that is not in the replacer");
+    it->second.RecordAccess(timestamp);
+  }
+  buffer->accesses_.clear();
+}
+
+void LRUKReplacer::ApplyAccessBuffers() {
+  for (auto &buffer : access_buffers_) {
+    ApplyAccessBuffer(&buffer);
+  }
+}
 
-void LRUKReplacer::RecordAccess(frame_id_t frame_id, [[maybe_unused]] AccessType access_type) {}
+void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  std::scoped_lock lock(latch_);
+  auto it = node_store_.find(frame_id);
+  if (it == node_store_.end() || it->second.IsEvictable() == set_evictable) {
+    return;
+  }
+  it->second.SetEvictable(set_evictable);
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
 
-void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {}
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock lock(latch_);
+  // A hit collected before the frame was unpinned must not outlive the frame's history.
+  ApplyAccessBuffers();
+  auto it = node_store_.find(frame_id);
+  if (it == node_store_.end()) {
+    return;
+  }
+  BUSTUB_ASSERT(it->second.IsEvictable(), "cannot remove a non-evictable frame");
+  node_store_.erase(it);
+  curr_size_--;
+}
 
-void LRUKReplacer::Remove(frame_id_t frame_id) {}
+auto LRUKReplacer::Size() -> size_t {
+  std::scoped_lock lock(latch_);
+  return curr_size_;
+}
 
-auto LRUKReplacer::Size() -> size_t { return 0; }
+void LRUKReplacer::Resize(size_t num_frames) {
+  std::scoped_lock lock(latch_);
+  for (const auto &[fid, node] : node_store_) {
+    BUSTUB_ASSERT(static_cast<size_t>(fid) < num_frames, "cannot drop a frame that is still in the replacer");
+  }
+  replacer_size_ = num_frames;
+}
 
 }  // namespace bustub
@@ -12,18 +12,99 @@
 
 #include "buffer/lru_replacer.h"
 
+#include "common/macros.h"
+
 namespace bustub {
 
-LRUReplacer::LRUReplacer(size_t num_pages) {}
+LRUReplacer::LRUReplacer(size_t num_pages)
+    : position_(num_pages), in_replacer_(num_pages, false), evictable_(num_pages, false) {}
 
 LRUReplacer::~LRUReplacer() = default;
 
-auto LRUReplacer::Victim(frame_id_t *frame_id) -> bool { return false; }
+auto LRUReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock lock(latch_);
+  for (auto fid : lru_list_) {
+    if (evictable_[fid]) {
+      *frame_id = fid;
+      Drop(fid);
+      return true;
+    }
+  }
+  return false;
+}
+
+void LRUReplacer::RecordAccess(frame_id_t frame_id, [[maybe_unused]] AccessType access_type,
+                               [[maybe_unused]] page_id_t page_id) {
+  std::scoped_lock lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < in_replacer_.size(), "invalid frame id");
+  if (in_replacer_[frame_id]) {
+    lru_list_.erase(position_[frame_id]);
+  }
+  in_replacer_[frame_id] = true;
+  position_[frame_id] = lru_list_.insert(lru_list_.end(), frame_id);
+}
+
+void LRUReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < in_replacer_.size(), "invalid frame id");
+  std::scoped_lock lock(latch_);
+  if (!in_replacer_[frame_id] || evictable_[frame_id] == set_evictable) {
+    return;
+  }
+  evictable_[frame_id] = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
+
+void LRUReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock lock(latch_);
+  if (!in_replacer_[frame_id]) {
+    return;
+  }
+  BUSTUB_ASSERT(evictable_[frame_id], "cannot remove a non-evictable frame");
+  Drop(frame_id);
+}
+
+auto LRUReplacer::Size() -> size_t {
+  std::scoped_lock lock(latch_);
+  return curr_size_;
+}
+
+void LRUReplacer::Resize(size_t num_frames) {
+  std::scoped_lock lock(latch_);
+  position_.resize(num_frames);
+  in_replacer_.resize(num_frames, false);
+  evictable_.resize(num_frames, false);
+}
 
-void LRUReplacer::Pin(frame_id_t frame_id) {}
+void LRUReplacer::Pin(frame_id_t frame_id) {
+  std::scoped_lock lock(latch_);
+  if (in_replacer_[frame_id]) {
+    Drop(frame_id);
+  }
+}
 
-void LRUReplacer::Unpin(frame_id_t frame_id) {}
+void LRUReplacer::Unpin(frame_id_t frame_id) {
+  bool in_replacer;
+  {
+    std::scoped_lock lock(latch_);
+    in_replacer = in_replacer_[frame_id];
+  }
+  if (!in_replacer) {
+    RecordAccess(frame_id);
+  }
+  SetEvictable(frame_id, true);
+}
 
-auto LRUReplacer::Size() -> size_t { return 0; }
+void LRUReplacer::Drop(frame_id_t frame_id) {
+  lru_list_.erase(position_[frame_id]);
+  in_replacer_[frame_id] = false;
+  if (evictable_[frame_id]) {
+    evictable_[frame_id] = false;
+    curr_size_--;
+  }
+}
 
 }  // namespace bustub
@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.cpp
+//
+// Identification: src/buffer/two_queue_replacer.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/two_queue_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+// The sizes recommended by the 2Q paper: A1in gets 25% of the frames, A1out remembers as many pages as fit in 50%.
+TwoQueueReplacer::TwoQueueReplacer(size_t num_frames)
+    : frames_(num_frames), k_in_(std::max<size_t>(num_frames / 4, 1)), k_out_(std::max<size_t>(num_frames / 2, 1)) {}
+
+auto TwoQueueReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock lock(latch_);
+  const frame_id_t a1_victim = FindVictim(a1_in_);
+  const frame_id_t am_victim = FindVictim(am_);
+  if (a1_victim == INVALID_FRAME_ID && am_victim == INVALID_FRAME_ID) {
+    return false;
+  }
+  const bool from_a1 = a1_victim != INVALID_FRAME_ID && (a1_in_.size() > k_in_ || am_victim == INVALID_FRAME_ID);
+  *frame_id = from_a1 ? a1_victim : am_victim;
+
+  const page_id_t page_id = frames_[*frame_id].page_id_;
+  Drop(*frame_id);
+  if (from_a1 && page_id != INVALID_PAGE_ID) {
+    a1_out_.Push(page_id);
+    while (a1_out_.Size() > k_out_) {
+      a1_out_.PopOldest();
+    }
+  }
+  return true;
+}
+
+void TwoQueueReplacer::RecordAccess(frame_id_t frame_id, [[maybe_unused]] AccessType access_type,
+                                    page_id_t page_id) {
+  std::scoped_lock lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "invalid frame id");
+  auto &entry = frames_[frame_id];
+  if (entry.list_ == ListId::Am) {
+    MoveTo(frame_id, ListId::Am);
+    return;
+  }
+  if (entry.list_ == ListId::A1In) {
+    // Correlated reference shortly after the page was loaded; leave the frame where it is.
+    return;
+  }
+
+  entry.page_id_ = page_id;
+  if (page_id != INVALID_PAGE_ID && a1_out_.Erase(page_id)) {
+    MoveTo(frame_id, ListId::Am);
+  } else {
+    MoveTo(frame_id, ListId::A1In);
+  }
+}
+
+void TwoQueueReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "invalid frame id");
+  std::scoped_lock lock(latch_);
+  auto &entry = frames_[frame_id];
+  if (entry.list_ == ListId::None || entry.evictable_ == set_evictable) {
+    return;
+  }
+  entry.evictable_ = set_evictable;
+  if (set_evictable) {
+    curr_size_++;
+  } else {
+    curr_size_--;
+  }
+}
+
+void TwoQueueReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock lock(latch_);
+  if (frames_[frame_id].list_ == ListId::None) {
+    return;
+  }
+  BUSTUB_ASSERT(frames_[frame_id].evictable_, "cannot remove a non-evictable frame");
+  Drop(frame_id);
+}
+
+auto TwoQueueReplacer::Size() -> size_t {
+  std::scoped_lock lock(latch_);
+  return curr_size_;
+}
+
+void TwoQueueReplacer::Resize(size_t num_frames) {
+  std::scoped_lock lock(latch_);
+  frames_.resize(num_frames);
+  k_in_ = std::max<size_t>(num_frames / 4, 1);
+  k_out_ = std::max<size_t>(num_frames / 2, 1);
+  while (a1_out_.Size() > k_out_) {
+    a1_out_.PopOldest();
+  }
+}
+
+auto TwoQueueReplacer::FindVictim(const std::list<frame_id_t> &list) const -> frame_id_t {
+  auto it = std::find_if(list.begin(), list.end(), [this](frame_id_t fid) { return frames_[fid].evictable_; });
+  return it == list.end() ? INVALID_FRAME_ID : *it;
+}
+
+void TwoQueueReplacer::MoveTo(frame_id_t frame_id, ListId list_id) {
+  auto &entry = frames_[frame_id];
+  if (entry.list_ != ListId::None) {
+    GetList(entry.list_).erase(entry.position_);
+  }
+  auto &list = GetList(list_id);
+  entry.list_ = list_id;
+  entry.position_ = list.insert(list.end(), frame_id);
+}
+
+void TwoQueueReplacer::Drop(frame_id_t frame_id) {
+  auto &entry = frames_[frame_id];
+  GetList(entry.list_).erase(entry.position_);
+  entry.list_ = ListId::None;
+  entry.page_id_ = INVALID_PAGE_ID;
+  if (entry.evictable_) {
+    entry.evictable_ = false;
+    curr_size_--;
+  }
+}
+
+}  // namespace bustub
@@ -5,6 +5,8 @@
 #include <shared_mutex>
 #include <string>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 #include "binder/binder.h"
 #include "binder/bound_expression.h"
@@ -14,6 +16,7 @@
 #include "binder/statement/index_statement.h"
 #include "binder/statement/select_statement.h"
 #include "binder/statement/set_show_statement.h"
+#include "binder/statement/vacuum_statement.h"
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "catalog/table_generator.h"
@@ -83,6 +86,44 @@ void BustubInstance::HandleIndexStatement(Transaction *txn, const IndexStatement
   WriteOneCell(fmt::format("Index created with id = {}", info->index_oid_), writer);
 }
 
+void BustubInstance::HandleVacuumStatement(Transaction *txn, const VacuumStatement &stmt, ResultWriter &writer) {
+  std::vector<TableInfo *> tables;
+  std::shared_lock<std::shared_mutex> l(catalog_lock_);
+  if (stmt.table_ != nullptr) {
+    tables.push_back(catalog_->GetTable(stmt.table_->oid_));
+  } else {
+    for (const auto &name : catalog_->GetTableNames()) {
+      auto *table = catalog_->GetTable(name);
+      // Mock tables have no heap to vacuum.
+      if (table->table_ != nullptr) {
+        tables.push_back(table);
+      }
+    }
+  }
+  l.unlock();
+
+  writer.BeginTable(false);
+  writer.BeginHeader();
+  writer.WriteHeaderCell("table");
+  writer.WriteHeaderCell("pages");
+  writer.WriteHeaderCell("released_pages");
+  writer.WriteHeaderCell("reclaimed_bytes");
+  writer.EndHeader();
+  for (auto *table : tables) {
+    if (table->table_ == nullptr) {
+      throw bustub::Exception(fmt::format("table {} has no heap to vacuum", table->name_));
+    }
+    auto stats = table->table_->Vacuum();
+    writer.BeginRow();
+    writer.WriteCell(table->name_);
+    writer.WriteCell(fmt::format("{}", stats.pages_));
+    writer.WriteCell(fmt::format("{}", stats.released_pages_));
+    writer.WriteCell(fmt::format("{}", stats.reclaimed_bytes_));
+    writer.EndRow();
+  }
+  writer.EndTable();
+}
+
 void BustubInstance::HandleExplainStatement(Transaction *txn, const ExplainStatement &stmt, ResultWriter &writer) {
   std::string output;
 
@@ -127,12 +168,79 @@ void BustubInstance::HandleExplainStatement(Transaction *txn, const ExplainState
 
 void BustubInstance::HandleVariableShowStatement(Transaction *txn, const VariableShowStatement &stmt,
                                                  ResultWriter &writer) {
+  if (StringUtil::Lower(stmt.variable_) == "buffer_pool_stats") {
+    DisplayBufferPoolStats(writer);
+    return;
+  }
+  if (StringUtil::Lower(stmt.variable_) == "buffer_pool_size") {
+    WriteOneCell(fmt::format("{}={}", stmt.variable_, buffer_pool_manager_->GetPoolSize()), writer);
+    return;
+  }
+  if (StringUtil::Lower(stmt.variable_) == "page_size") {
+    WriteOneCell(fmt::format("{}={}", stmt.variable_, disk_manager_->GetPageSize()), writer);
+    return;
+  }
   auto content = GetSessionVariable(stmt.variable_);
   WriteOneCell(fmt::format("{}={}", stmt.variable_, content), writer);
 }
 
+void BustubInstance::DisplayBufferPoolStats(ResultWriter &writer) {
+  if (buffer_pool_manager_ == nullptr) {
+    WriteOneCell("buffer pool statistics are not available: there is no buffer pool", writer);
+    return;
+  }
+  auto stats = buffer_pool_manager_->GetStats();
+  std::vector<std::pair<std::string, std::string>> rows = {
+      {"hits", fmt::format("{}", stats.hits_)},
+      {"misses", fmt::format("{}", stats.misses_)},
+      {"hit_ratio", fmt::format("{:.4f}", stats.HitRatio())},
+      {"evictions", fmt::format("{}", stats.evictions_)},
+      {"dirty_write_backs", fmt::format("{}", stats.dirty_write_backs_)},
+      {"cleaner_write_backs", fmt::format("{}", buffer_pool_manager_->GetCleanerWriteBacks())},
+      {"pin_waits", fmt::format("{}", stats.pin_waits_)},
+      {"latch_acquisitions", fmt::format("{}", BufferPoolStatsSnapshot::Count(stats.latch_wait_ns_))},
+  };
+  for (const auto &[name, histogram] : {std::make_pair("latch_wait", &stats.latch_wait_ns_),
+                                        std::make_pair("latch_hold", &stats.latch_hold_ns_)}) {
+    for (auto percentile : {50, 90, 99}) {
+      rows.emplace_back(fmt::format("{}_p{}_ns", name, percentile),
+                        fmt::format("{}", BufferPoolStatsSnapshot::Percentile(*histogram, percentile)));
+    }
+  }
+
+  writer.BeginTable(false);
+  writer.BeginHeader();
+  writer.WriteHeaderCell("name");
+  writer.WriteHeaderCell("value");
+  writer.EndHeader();
+  for (const auto &[name, value] : rows) {
+    writer.BeginRow();
+    writer.WriteCell(name);
+    writer.WriteCell(value);
+    writer.EndRow();
+  }
+  writer.EndTable();
+}
+
 void BustubInstance::HandleVariableSetStatement(Transaction *txn, const VariableSetStatement &stmt,
                                                 ResultWriter &writer) {
+  if (StringUtil::Lower(stmt.variable_) == "buffer_pool_size") {
+    // The buffer pool is shared by all sessions, so this is a system variable rather than a session one.
+    size_t pool_size = 0;
+    try {
+      pool_size = std::stoul(stmt.value_);
+    } catch (const std::exception &e) {
+      throw Exception(fmt::format("invalid buffer_pool_size: {}", stmt.value_));
+    }
+    if (pool_size < buffer_pool_manager_->GetNumInstances() || pool_size > buffer_pool_manager_->GetMaxPoolSize()) {
+      throw Exception(fmt::format("buffer_pool_size must be between {} and {}", buffer_pool_manager_->GetNumInstances(),
+                                  buffer_pool_manager_->GetMaxPoolSize()));
+    }
+    if (!buffer_pool_manager_->ResizePool(pool_size)) {
+      throw Exception("buffer_pool_size unchanged: pages beyond the new size are still pinned");
+    }
+    return;
+  }
   session_variables_[stmt.variable_] = stmt.value_;
 }
 
@@ -11,6 +11,7 @@
 #include "binder/statement/index_statement.h"
 #include "binder/statement/select_statement.h"
 #include "binder/statement/set_show_statement.h"
+#include "binder/statement/vacuum_statement.h"
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "catalog/table_generator.h"
@@ -42,11 +43,11 @@ auto BustubInstance::MakeExecutorContext(Transaction *txn) -> std::unique_ptr<Ex
   return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_);
 }
 
-BustubInstance::BustubInstance(const std::string &db_file_name) {
+BustubInstance::BustubInstance(const std::string &db_file_name, size_t page_size) {
   enable_logging = false;
 
   // Storage related.
-  disk_manager_ = new DiskManager(db_file_name);
+  disk_manager_ = new DiskManager(db_file_name, false, page_size);
 
   // Log related.
   log_manager_ = new LogManager(disk_manager_);
@@ -55,6 +56,11 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   // buffer pool size specified in `config.h`.
   try {
     buffer_pool_manager_ = new BufferPoolManager(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    // Table scans read the heap ahead and stay within a ring of frames, so they overlap with their own disk reads and
+    // do not push the rest of the working set out of the pool.
+    buffer_pool_manager_->SetReadAheadWindow(8);
+    buffer_pool_manager_->SetScanRingSize(16);
+    buffer_pool_manager_->StartPageCleaner();
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
@@ -74,11 +80,11 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
 }
 
-BustubInstance::BustubInstance() {
+BustubInstance::BustubInstance(size_t page_size) {
   enable_logging = false;
 
   // Storage related.
-  disk_manager_ = new DiskManagerUnlimitedMemory();
+  disk_manager_ = new DiskManagerUnlimitedMemory(page_size);
 
   // Log related.
   log_manager_ = new LogManager(disk_manager_);
@@ -87,6 +93,7 @@ BustubInstance::BustubInstance() {
   // buffer pool size specified in `config.h`.
   try {
     buffer_pool_manager_ = new BufferPoolManager(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    buffer_pool_manager_->StartPageCleaner();
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
@@ -161,6 +168,10 @@ void BustubInstance::CmdDisplayHelp(ResultWriter &writer) {
 \dt: show all tables
 \di: show all indices
 \help: show this message again
+show buffer_pool_stats: show buffer pool hit, eviction and latch counters
+set buffer_pool_size = <frames>: resize the buffer pool
+show page_size: show the page size the database was opened with
+vacuum [<table>]: reclaim the space of deleted tuples in one or all tables
 
 BusTub shell currently only supports a small set of Postgres queries. We'll set
 up a doc describing the current status later. It will silently ignore some parts
@@ -242,6 +253,11 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         HandleExplainStatement(txn, explain_stmt, writer);
         continue;
       }
+      case StatementType::VACUUM_STATEMENT: {
+        const auto &vacuum_stmt = dynamic_cast<const VacuumStatement &>(*statement);
+        HandleVacuumStatement(txn, vacuum_stmt, writer);
+        continue;
+      }
       default:
         break;
     }
@@ -329,6 +345,10 @@ void BustubInstance::GenerateMockTable() {
 }
 
 BustubInstance::~BustubInstance() {
+  // The page cleaner reads the log manager, stop it before anything is torn down.
+  if (buffer_pool_manager_ != nullptr) {
+    buffer_pool_manager_->StopPageCleaner();
+  }
   if (enable_logging) {
     log_manager_->StopFlushThread();
   }
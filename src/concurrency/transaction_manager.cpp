@@ -54,6 +54,8 @@ void TransactionManager::Commit(Transaction *txn) {
     if (item.wtype_ == WType::DELETE) {
       // Note that this also releases the lock when holding the page latch.
       table->ApplyDelete(item.rid_, txn);
+    } else if (item.wtype_ == WType::UPDATE) {
+      table->ApplyUpdate(item.tuple_, txn);
     }
     write_set->pop_back();
   }
@@ -78,7 +80,7 @@ void TransactionManager::Abort(Transaction *txn) {
       // Note that this also releases the lock when holding the page latch.
       table->ApplyDelete(item.rid_, txn);
     } else if (item.wtype_ == WType::UPDATE) {
-      table->UpdateTuple(item.tuple_, item.rid_, txn);
+      table->RollbackUpdate(item.tuple_, item.rid_, txn);
     }
     table_write_set->pop_back();
   }
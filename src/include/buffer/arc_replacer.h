@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.h
+//
+// Identification: src/include/buffer/arc_replacer.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/ghost_list.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ARCReplacer implements the Adaptive Replacement Cache policy.
+ *
+ * Resident frames are split into T1, frames whose page was accessed once since it was loaded, and T2, frames whose
+ * page was accessed again. Both are kept in LRU order. The ids of pages recently evicted from T1 and T2 are
+ * remembered in the ghost lists B1 and B2. When an evicted page is read back, a hit in B1 grows the target size p of
+ * T1 and a hit in B2 shrinks it, so the split between recency and frequency adapts to the workload. Evict() takes the
+ * LRU evictable frame of T1 while T1 is larger than p, and of T2 otherwise.
+ *
+ * A scan access never promotes a frame from T1 to T2, so a page touched repeatedly by one scan stays in T1.
+ */
+class ARCReplacer : public Replacer {
+ public:
+  /**
+   * @brief Create a new ARCReplacer.
+   * @param num_frames the maximum number of frames the replacer will be required to store
+   */
+  explicit ARCReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(ARCReplacer);
+
+  ~ARCReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                    page_id_t page_id = INVALID_PAGE_ID) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  void Resize(size_t num_frames) override;
+
+  /** @return the current target size of T1 */
+  auto GetTargetT1Size() -> size_t;
+
+ private:
+  enum class ListId { None = 0, T1, T2 };
+
+  /** What the replacer knows about a frame. */
+  struct FrameEntry {
+    ListId list_{ListId::None};
+    std::list<frame_id_t>::iterator position_;
+    page_id_t page_id_{INVALID_PAGE_ID};
+    bool evictable_{false};
+  };
+
+  /** @return the list a frame in `list_id` lives in */
+  auto GetList(ListId list_id) -> std::list<frame_id_t> & { return list_id == ListId::T1 ? t1_ : t2_; }
+
+  /** @return the least recently used evictable frame of the list, or INVALID_FRAME_ID if there is none */
+  auto FindVictim(const std::list<frame_id_t> &list) const -> frame_id_t;
+
+  /** Move a frame to the most recently used end of a list. Caller must hold the latch. */
+  void MoveTo(frame_id_t frame_id, ListId list_id);
+
+  /** Take a frame out of T1 / T2. Caller must hold the latch. */
+  void Drop(frame_id_t frame_id);
+
+  /** Forget the oldest ghosts once the ghost lists outgrow the cache. Caller must hold the latch. */
+  void TrimGhosts();
+
+  static constexpr frame_id_t INVALID_FRAME_ID = -1;
+
+  std::vector<FrameEntry> frames_;
+  /** Frames accessed once since their page was loaded, least recently used first. */
+  std::list<frame_id_t> t1_;
+  /** Frames accessed at least twice, least recently used first. */
+  std::list<frame_id_t> t2_;
+  /** Pages recently evicted from T1. */
+  GhostList b1_;
+  /** Pages recently evicted from T2. */
+  GhostList b2_;
+  /** Target size of T1. */
+  size_t p_{0};
+  size_t curr_size_{0};
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -12,15 +12,22 @@
 
 #pragma once
 
-#include <list>
+#include <array>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
 #include <memory>
-#include <mutex>  // NOLINT
-#include <unordered_map>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
 
+#include "buffer/buffer_pool_manager_instance.h"
 #include "buffer/lru_k_replacer.h"
+#include "buffer/replacer.h"
 #include "common/config.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_scheduler.h"
 #include "storage/page/page.h"
 #include "storage/page/page_guard.h"
 
@@ -28,6 +35,21 @@ namespace bustub {
 
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
+ *
+ * The frames are split across one or more BufferPoolManagerInstances. Every page id is owned by exactly one instance
+ * (`page_id % num_instances`), and each instance has its own latch, page table, free list and replacer, so threads
+ * working on pages of different instances do not serialize on a single latch. All instances share one DiskScheduler,
+ * so their disk reads and writes also proceed in parallel.
+ *
+ * The data of all frames lives in a single anonymous mapping that the kernel is asked to back with transparent huge
+ * pages, while the Page metadata sits in a separate, cache-line aligned array. Both are reserved up front for the
+ * maximum pool size and only committed for the frames in use, so ResizePool() can grow or shrink the pool at its end
+ * without moving any frame.
+ *
+ * Scans report the page they are on and the next page of their chain through ReadAheadHint(). A background thread then
+ * follows the chain and reads the next pages into the pool, so that the scan finds them already cached. Pages read by
+ * AccessType::Scan fetches are confined to a small ring of frames per instance, so a large scan does not evict the
+ * working set of point lookups. Both are off until enabled with SetReadAheadWindow() and SetScanRingSize().
  */
 class BufferPoolManager {
  public:
@@ -37,9 +59,12 @@ class BufferPoolManager {
    * @param disk_manager the disk manager
    * @param replacer_k the lookback constant k for the LRU-K replacer
    * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param num_instances the number of instances the frames are split into, capped at pool_size
+   * @param replacer_type the replacement policy of every instance
    */
   BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
-                    LogManager *log_manager = nullptr);
+                    LogManager *log_manager = nullptr, size_t num_instances = BUFFER_POOL_INSTANCES,
+                    ReplacerType replacer_type = ReplacerType::LRUK);
 
   /**
    * @brief Destroy an existing BufferPoolManager.
@@ -49,22 +74,107 @@ class BufferPoolManager {
   /** @brief Return the size (number of frames) of the buffer pool. */
   auto GetPoolSize() -> size_t { return pool_size_; }
 
+  /** @brief Return the size of every page in bytes, as configured on the disk manager. */
+  auto GetPageSize() -> size_t { return page_size_; }
+
+  /** @brief Return the largest size ResizePool() accepts. */
+  auto GetMaxPoolSize() -> size_t { return max_pool_size_; }
+
+  /**
+   * @brief Grow or shrink the buffer pool while it is in use. Growing hands the new frames to the instances right
+   * away. Shrinking evicts the pages held by the frames beyond the new size, writing dirty ones back, and blocks until
+   * every pinned page among them has been unpinned. If that takes longer than the timeout, e.g. because the caller
+   * holds one of the pins itself, the pool keeps its old size. Concurrent resizes are serialized.
+   * @param pool_size the new number of frames
+   * @param timeout how long a shrink waits for the pinned pages
+   * @return false if the size is below the number of instances or above the maximum pool size, or if the shrink
+   * timed out
+   */
+  auto ResizePool(size_t pool_size,
+                  std::chrono::milliseconds timeout = std::chrono::milliseconds(RESIZE_POOL_TIMEOUT_MS)) -> bool;
+
   /** @brief Return the pointer to all the pages in the buffer pool. */
   auto GetPages() -> Page * { return pages_; }
 
+  /** @brief Return the number of instances the buffer pool is split into. */
+  auto GetNumInstances() -> size_t { return instances_.size(); }
+
+  /**
+   * @brief Set how many pages are read ahead of a sequential scan; 0 disables read-ahead.
+   *
+   * Every instance keeps at most a quarter of its frames for prefetched pages that have not been fetched yet, so
+   * the effective window may be smaller than requested on small pools.
+   *
+   * @param window the requested number of pages to keep in flight ahead of each scan
+   */
+  void SetReadAheadWindow(size_t window);
+
+  /** @brief Return the effective read-ahead window. */
+  auto GetReadAheadWindow() -> size_t;
+
+  /**
+   * @brief Tell the read-ahead logic that a scan is on page_id, and that next_page_id follows it in the chain it
+   * scans. The scan's chain is read ahead up to the window, using next_of to find the page after each page read;
+   * once less than half of the window is left ahead of the scan, it is topped up. Repeated hints for the same page
+   * are ignored, so a scan may hint once per tuple.
+   *
+   * @param page_id the page the scan is on
+   * @param next_page_id the page the scan moves to next, as read from page_id's header
+   * @param next_of reads the next page id from the data of a page of the chain
+   */
+  void ReadAheadHint(page_id_t page_id, page_id_t next_page_id, NextPageIdFn next_of);
+
   /**
-   * TODO(P1): Add implementation
+   * @brief Set the number of frames that AccessType::Scan fetches recycle among; 0 disables the scan ring.
    *
+   * The frames are split evenly across the instances, and each instance is capped at a quarter of its frames.
+   * @see BufferPoolManagerInstance::SetScanRingSize
+   *
+   * @param scan_ring_size the requested total number of scan ring frames
+   */
+  void SetScanRingSize(size_t scan_ring_size);
+
+  /** @brief Return the effective total number of scan ring frames. */
+  auto GetScanRingSize() -> size_t;
+
+  /**
+   * @brief Start the background page cleaner. Every `page_cleaner_interval` it writes back dirty, unpinned pages so
+   * that NewPage and FetchPage find clean victims and do not pay for a write themselves.
+   *
+   * The cleaner reads the persistent LSN of the log manager, so it must be stopped before the log manager is
+   * destroyed.
+   *
+   * @param clean_frame_percent the share of frames (in percent) to keep free or clean
+   */
+  void StartPageCleaner(size_t clean_frame_percent = CLEAN_FRAME_TARGET);
+
+  /** @brief Stop the background page cleaner, if it is running. */
+  void StopPageCleaner();
+
+  /**
+   * @brief Run a single page cleaner pass over every instance.
+   * @param clean_frame_percent the share of frames (in percent) to keep free or clean
+   * @return the number of pages written
+   */
+  auto CleanFrames(size_t clean_frame_percent) -> size_t;
+
+  /** @brief Return the number of dirty victims NewPage and FetchPage had to write back themselves. */
+  auto GetForegroundWriteBacks() -> size_t;
+
+  /** @brief Return the number of pages written by the page cleaner. */
+  auto GetCleanerWriteBacks() -> size_t { return cleaner_write_backs_; }
+
+  /** @brief Return the hit, eviction, write-back and latch counters summed over all instances. */
+  auto GetStats() -> BufferPoolStatsSnapshot;
+
+  /**
    * @brief Create a new page in the buffer pool. Set page_id to the new page's id, or nullptr if all frames
    * are currently in use and not evictable (in another word, pinned).
    *
-   * You should pick the replacement frame from either the free list or the replacer (always find from the free list
-   * first), and then call the AllocatePage() method to get a new page id. If the replacement frame has a dirty page,
-   * you should write it back to the disk first. You also need to reset the memory and metadata for the new page.
-   *
-   * Remember to "Pin" the frame by calling replacer.SetEvictable(frame_id, false)
-   * so that the replacer wouldn't evict the frame before the buffer pool manager "Unpin"s it.
-   * Also, remember to record the access history of the frame in the replacer for the lru-k algorithm to work.
+   * The instances are tried in round-robin order starting from a rotating index, and the first instance that can
+   * provide a frame allocates the page id. Within an instance the replacement frame comes from the free list first
+   * and then from the replacer; a dirty victim is written back before the frame is reused. The page id is the lowest
+   * deallocated id owned by the instance if there is one, so the database file only grows once no page can be reused.
    *
    * @param[out] page_id id of created page
    * @return nullptr if no new pages could be created, otherwise pointer to new page
@@ -72,8 +182,6 @@ class BufferPoolManager {
   auto NewPage(page_id_t *page_id) -> Page *;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief PageGuard wrapper for NewPage
    *
    * Functionality should be the same as NewPage, except that
@@ -86,13 +194,11 @@ class BufferPoolManager {
   auto NewPageGuarded(page_id_t *page_id) -> BasicPageGuard;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Fetch the requested page from the buffer pool. Return nullptr if page_id needs to be fetched from the disk
    * but all frames are currently in use and not evictable (in another word, pinned).
    *
    * First search for page_id in the buffer pool. If not found, pick a replacement frame from either the free list or
-   * the replacer (always find from the free list first), read the page from disk by calling disk_manager_->ReadPage(),
+   * the replacer (always find from the free list first), read the page from disk through the disk scheduler,
    * and replace the old page in the frame. Similar to NewPage(), if the old page is dirty, you need to write it back
    * to disk and update the metadata of the new page
    *
@@ -105,8 +211,6 @@ class BufferPoolManager {
   auto FetchPage(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> Page *;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief PageGuard wrappers for FetchPage
    *
    * Functionality should be the same as FetchPage, except
@@ -122,8 +226,19 @@ class BufferPoolManager {
   auto FetchPageWrite(page_id_t page_id) -> WritePageGuard;
 
   /**
-   * TODO(P1): Add implementation
+   * Fetch a page for an optimistic read: the page is pinned but not latched, and the returned guard remembers the
+   * page version. Whatever is read through the guard is only valid if ReadPageGuard::Validate succeeds afterwards.
    *
+   * Only the page latch is skipped. Pinning goes through FetchPage, so the instance latch is taken and the access is
+   * recorded with the replacer as for any other fetch. The pin is what keeps the frame from being reused for another
+   * page, or decommitted by ResizePool, while the guard reads it.
+   *
+   * @param page_id, the id of the page to fetch
+   * @return an optimistic ReadPageGuard holding the fetched page
+   */
+  auto FetchPageOptimistic(page_id_t page_id) -> ReadPageGuard;
+
+  /**
    * @brief Unpin the target page from the buffer pool. If page_id is not in the buffer pool or its pin count is already
    * 0, return false.
    *
@@ -138,11 +253,9 @@ class BufferPoolManager {
   auto UnpinPage(page_id_t page_id, bool is_dirty, AccessType access_type = AccessType::Unknown) -> bool;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Flush the target page to disk.
    *
-   * Use the DiskManager::WritePage() method to flush a page to disk, REGARDLESS of the dirty flag.
+   * Use the DiskScheduler to flush a page to disk, REGARDLESS of the dirty flag.
    * Unset the dirty flag of the page after flushing.
    *
    * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
@@ -151,21 +264,20 @@ class BufferPoolManager {
   auto FlushPage(page_id_t page_id) -> bool;
 
   /**
-   * TODO(P1): Add implementation
+   * @brief Flush all the dirty pages in the buffer pool to disk.
    *
-   * @brief Flush all the pages in the buffer pool to disk.
+   * Clean pages are skipped. The dirty pages are written in page id order, and each run of consecutive page ids is
+   * merged into one vectored write.
    */
   void FlushAllPages();
 
   /**
-   * TODO(P1): Add implementation
-   *
-   * @brief Delete a page from the buffer pool. If page_id is not in the buffer pool, do nothing and return true. If the
-   * page is pinned and cannot be deleted, return false immediately.
+   * @brief Delete a page from the buffer pool and deallocate it on disk. If page_id is not in the buffer pool, only
+   * deallocate it and return true. If the page is pinned and cannot be deleted, return false immediately.
    *
    * After deleting the page from the page table, stop tracking the frame in the replacer and add the frame
-   * back to the free list. Also, reset the page's memory and metadata. Finally, you should call DeallocatePage() to
-   * imitate freeing the page on the disk.
+   * back to the free list. Also, reset the page's memory and metadata. Finally, DeallocatePage() records the page in
+   * the disk manager's free-page map, from which NewPage reuses it.
    *
    * @param page_id id of page to be deleted
    * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
@@ -173,40 +285,127 @@ class BufferPoolManager {
   auto DeletePage(page_id_t page_id) -> bool;
 
  private:
-  /** Number of pages in the buffer pool. */
-  const size_t pool_size_;
-  /** The next page id to be allocated  */
-  std::atomic<page_id_t> next_page_id_ = 0;
+  /** Number of concurrent scans tracked for read-ahead. */
+  static constexpr size_t READ_AHEAD_STREAMS = 8;
 
-  /** Array of buffer pool pages. */
-  Page *pages_;
-  /** Pointer to the disk manager. */
-  DiskManager *disk_manager_ __attribute__((__unused__));
-  /** Pointer to the log manager. Please ignore this for P1. */
-  LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
-  /** Replacer to find unpinned pages for replacement. */
-  std::unique_ptr<LRUKReplacer> replacer_;
-  /** List of free frames that don't have any pages on them. */
-  std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
-  std::mutex latch_;
+  /** A scan followed by the read-ahead logic along the chain of pages it reported. */
+  struct ReadAheadStream {
+    /** The last page the scan was hinted to be on. */
+    page_id_t last_page_id_{INVALID_PAGE_ID};
+    /** Pages read ahead of the scan that it has not reached yet, in chain order. */
+    std::deque<page_id_t> ahead_;
+    /** The page after the last one in ahead_, or INVALID_PAGE_ID if it is unknown or the chain ends. */
+    page_id_t resume_page_id_{INVALID_PAGE_ID};
+    /** Whether the read-ahead thread is still following the chain for this stream. */
+    bool in_flight_{false};
+    /** Reads the next page id from the data of a page of the chain. */
+    NextPageIdFn next_of_{nullptr};
+    /** Identifies the scan the slot was last given to; requests queued for an earlier one are dropped. 0 = unused. */
+    uint64_t generation_{0};
+  };
 
-  /**
-   * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
-   * @return the id of the allocated page
-   */
-  auto AllocatePage() -> page_id_t;
+  /** Pages of a stream's chain to read ahead, starting at page_id_. */
+  struct ReadAheadRequest {
+    size_t stream_;
+    uint64_t generation_;
+    page_id_t page_id_;
+    size_t count_;
+  };
+
+  /** @brief Queue reading count pages of the stream's chain ahead, starting at page_id. Caller holds the latch. */
+  void QueueReadAhead(size_t stream, page_id_t page_id, size_t count);
+
+  /** @brief Cap the read-ahead window to what the instances allow prefetching and start the thread if needed. */
+  void ApplyReadAheadWindow(size_t window);
+
+  /** @brief Split the scan ring frames across the instances, each capped to a quarter of its frames. */
+  void ApplyScanRingSize(size_t scan_ring_size);
 
   /**
-   * @brief Deallocate a page on disk. Caller should acquire the latch before calling this function.
-   * @param page_id id of the page to deallocate
+   * @brief Derive the effective read-ahead window and scan ring size from the requested ones again. Called after a
+   * resize, since a shrink caps them and a later grow has to lift the cap.
    */
-  void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
-    // This is a no-nop right now without a more complex data structure to track deallocated pages
+  void ApplyScanSettings();
+
+  /** @return the instance responsible for the given page id */
+  auto GetInstance(page_id_t page_id) -> BufferPoolManagerInstance * {
+    return instances_[static_cast<size_t>(page_id) % instances_.size()].get();
   }
 
-  // TODO(student): You may add additional private members and helper functions
+  /** @brief Body of the background thread that reads the queued pages into the pool. */
+  void ReadAheadWorker();
+
+  /** @brief Body of the page cleaner thread. */
+  void PageCleanerWorker(size_t clean_frame_percent);
+
+  /** @return the number of frames instance `index` of `num_instances` owns in a pool of `pool_size` frames */
+  static auto GetInstanceSize(size_t index, size_t num_instances, size_t pool_size) -> size_t {
+    return pool_size / num_instances + (index < pool_size % num_instances ? 1 : 0);
+  }
+
+  /** @brief Make the memory of frames [from, to) accessible and construct their Page objects. */
+  void CommitFrames(size_t from, size_t to);
+
+  /** @brief Destroy the Page objects of frames [from, to) and return their memory to the kernel. */
+  void DecommitFrames(size_t from, size_t to);
+
+  /** Number of pages in the buffer pool. */
+  std::atomic<size_t> pool_size_;
+  /** Number of frames the address space is reserved for. */
+  const size_t max_pool_size_;
+  /** Size of a page, and so of a frame, in bytes. */
+  const size_t page_size_;
+  /** Serializes ResizePool calls. */
+  std::mutex resize_latch_;
+  /** Instance at which the next NewPage call starts looking for a free frame. */
+  std::atomic<size_t> next_instance_ = 0;
+  /** Runs the disk reads and writes of every instance on a pool of worker threads. */
+  std::unique_ptr<DiskScheduler> disk_scheduler_;
+
+  /** Array of buffer pool pages, reserved for max_pool_size_ frames. Instance `i` owns every page `f` with
+   * `f % num_instances == i`. */
+  Page *pages_{nullptr};
+  /** Size of the mapping behind pages_ in bytes. */
+  size_t pages_size_{0};
+  /** The data of every frame, one aligned and contiguous mapping; frame `i` starts at `i * page_size_`. */
+  char *frame_arena_{nullptr};
+  /** Size of frame_arena_ in bytes, rounded up to whole huge pages. The arena also starts on a huge page boundary. */
+  size_t frame_arena_size_{0};
+  /** The buffer pool instances; page `p` lives in instance `p % instances_.size()`. */
+  std::vector<std::unique_ptr<BufferPoolManagerInstance>> instances_;
+  /** Scan ring size as last set by SetScanRingSize(), before capping to the pool size. */
+  std::atomic<size_t> requested_scan_ring_size_{0};
+
+  /** Protects every read-ahead member below. */
+  std::mutex read_ahead_latch_;
+  /** Signals the read-ahead thread that pages were queued or that it should stop. */
+  std::condition_variable read_ahead_cv_;
+  /** Number of pages read ahead of a scan as last set by SetReadAheadWindow(), before capping to the pool size. */
+  size_t requested_read_ahead_window_{0};
+  /** Effective number of pages read ahead of a scan; 0 = disabled. */
+  size_t read_ahead_window_{0};
+  /** Scans being followed, replaced round-robin. */
+  std::array<ReadAheadStream, READ_AHEAD_STREAMS> read_ahead_streams_;
+  /** Slot of read_ahead_streams_ that the next new stream replaces. */
+  size_t next_stream_{0};
+  /** Generation handed to the last new stream. */
+  uint64_t last_generation_{0};
+  /** Chains waiting to be read ahead. */
+  std::deque<ReadAheadRequest> read_ahead_queue_;
+  /** Tells the read-ahead thread to exit. */
+  bool stop_read_ahead_{false};
+  /** The read-ahead thread, started the first time read-ahead is enabled. */
+  std::thread read_ahead_thread_;
+
+  /** Protects stop_page_cleaner_ and page_cleaner_thread_. */
+  std::mutex page_cleaner_latch_;
+  /** Wakes the page cleaner up early when it should stop. */
+  std::condition_variable page_cleaner_cv_;
+  /** Tells the page cleaner to exit. */
+  bool stop_page_cleaner_{false};
+  /** The page cleaner thread, if started. */
+  std::thread page_cleaner_thread_;
+  /** Number of pages written by CleanFrames. */
+  std::atomic<size_t> cleaner_write_backs_{0};
 };
 }  // namespace bustub
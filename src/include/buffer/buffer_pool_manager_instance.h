@@ -0,0 +1,307 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_manager_instance.h
+//
+// Identification: src/include/buffer/buffer_pool_manager_instance.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <future>              // NOLINT
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_stats.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_scheduler.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/** Reads the id of the page that follows a page in its chain (e.g. a table heap) from the page's data. */
+using NextPageIdFn = page_id_t (*)(const char *page_data);
+
+/** Dirty pages collected by BufferPoolManagerInstance::BeginFlushAll(), possibly from several instances. */
+struct FlushBatch {
+  /** The id and data of every page to write. */
+  std::vector<std::pair<page_id_t, char *>> pages_;
+  /** I/O that was running on the frames when they were collected; it must be done before the pages are written. */
+  std::vector<std::shared_future<bool>> previous_io_;
+  /** Set once the pages are written, one promise per page. */
+  std::vector<std::promise<bool>> flushed_;
+};
+
+/**
+ * BufferPoolManagerInstance is one shard of the BufferPoolManager. It owns every `num_instances`-th frame together
+ * with its own page table, free list, replacer and latch, so that requests for pages living in different instances
+ * never contend with each other. Interleaving the frames lets the pool grow or shrink at its end while every instance
+ * keeps an equal share.
+ *
+ * Page ids are striped across instances: instance `i` of `n` only hands out and caches page ids with
+ * `page_id % n == i`. The semantics of every method match the corresponding method on BufferPoolManager.
+ */
+class BufferPoolManagerInstance {
+ public:
+  /**
+   * @brief Creates a new BufferPoolManagerInstance.
+   * @param pool_size the number of frames owned by this instance
+   * @param pages the frames of the whole buffer pool, frame `f` of this instance is
+   * `pages[f * num_instances + instance_index]`; the memory is owned by the caller
+   * @param num_instances total number of instances in the parallel buffer pool
+   * @param instance_index index of this instance in the parallel buffer pool
+   * @param disk_scheduler the disk scheduler that runs the reads and writes of this instance
+   * @param replacer_k the lookback constant k for the LRU-K replacer
+   * @param log_manager the log manager (nullptr = disable logging)
+   * @param replacer_type the replacement policy
+   */
+  BufferPoolManagerInstance(size_t pool_size, Page *pages, uint32_t num_instances, uint32_t instance_index,
+                            DiskScheduler *disk_scheduler, size_t replacer_k, LogManager *log_manager,
+                            ReplacerType replacer_type = ReplacerType::LRUK);
+
+  DISALLOW_COPY_AND_MOVE(BufferPoolManagerInstance);
+
+  ~BufferPoolManagerInstance() = default;
+
+  /** @brief Return the number of frames owned by this instance. */
+  auto GetPoolSize() -> size_t { return pool_size_; }
+
+  /**
+   * @brief Change the number of frames owned by this instance. New frames go to the free list right away; their
+   * Page objects must already exist. When shrinking, the frames beyond the new size are no longer handed out, the
+   * unpinned ones are evicted immediately and the pinned ones on their last UnpinPage. The previous shrink must have
+   * been drained, unless this call grows the instance back, in which case the frames not drained yet are live again.
+   * @param pool_size the new number of frames, at least 1
+   */
+  void Resize(size_t pool_size);
+
+  /**
+   * @brief Evict what has become evictable beyond the pool size and forget those frames once all are empty.
+   * @return the number of frames beyond the pool size still holding a (pinned) page
+   */
+  auto DrainFrames() -> size_t;
+
+  /** @brief Create a new page whose id belongs to this instance. @see BufferPoolManager::NewPage */
+  auto NewPage(page_id_t *page_id) -> Page *;
+
+  /** @brief Fetch a page owned by this instance. @see BufferPoolManager::FetchPage */
+  auto FetchPage(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> Page *;
+
+  /** @brief Unpin a page owned by this instance. @see BufferPoolManager::UnpinPage */
+  auto UnpinPage(page_id_t page_id, bool is_dirty, AccessType access_type = AccessType::Unknown) -> bool;
+
+  /** @brief Flush a page owned by this instance. @see BufferPoolManager::FlushPage */
+  auto FlushPage(page_id_t page_id) -> bool;
+
+  /** @brief Flush every dirty page cached by this instance. */
+  void FlushAllPages();
+
+  /**
+   * @brief Collect every dirty page for a flush that may span several instances, and mark the pages clean. The flush
+   * becomes the pending I/O of their frames, so no frame is reused before its page is written, while the latch is
+   * only held for collecting. The caller waits for batch->previous_io_, writes the pages and sets batch->flushed_.
+   * @param[out] batch the dirty pages are appended here
+   */
+  void BeginFlushAll(FlushBatch *batch);
+
+  /** @brief Delete a page owned by this instance. @see BufferPoolManager::DeletePage */
+  auto DeletePage(page_id_t page_id) -> bool;
+
+  /**
+   * @brief Read a page into the buffer pool ahead of its first use, without pinning it.
+   *
+   * The page is skipped if it is already cached or has never been allocated. A prefetched frame is not registered
+   * with the replacer until the page is actually fetched, so read-ahead never adds entries to the replacer's
+   * history. At most `GetMaxPrefetched()` frames hold prefetched-but-unused pages; beyond that the oldest one is
+   * recycled.
+   *
+   * @param page_id id of the page to read
+   * @param next_of if given, reads the id of the page following this one in its chain from the data just read, before
+   * any other thread can see the page
+   * @param[out] next_page_id what next_of returned, only set if the page was read
+   * @return true if the page was read from disk
+   */
+  auto PrefetchPage(page_id_t page_id, NextPageIdFn next_of = nullptr, page_id_t *next_page_id = nullptr) -> bool;
+
+  /** @brief Limit the number of frames holding prefetched-but-unused pages (capped at a quarter of the instance). */
+  void SetMaxPrefetched(size_t max_prefetched);
+
+  /** @brief Return the maximum number of frames holding prefetched-but-unused pages. */
+  auto GetMaxPrefetched() -> size_t;
+
+  /**
+   * @brief Set the number of frames in the scan ring (capped at a quarter of the instance); 0 disables the ring.
+   *
+   * Pages read by AccessType::Scan fetches are kept in a bounded ring of frames. Once the ring is full, a scan miss
+   * reuses the oldest unpinned ring frame instead of asking the replacer for a victim, so a large scan cycles
+   * through the ring and leaves the rest of the pool alone. Scan hits do not add to the LRU-K history, and a
+   * non-scan fetch moves a page out of the ring.
+   */
+  void SetScanRingSize(size_t scan_ring_size);
+
+  /** @brief Return the number of frames in the scan ring. */
+  auto GetScanRingSize() -> size_t;
+
+  /**
+   * @brief Write back dirty, unpinned pages until at least `target_clean_frames` frames are free or hold a clean,
+   * unpinned page.
+   *
+   * Pages are written one at a time, so the latch is never held for more than a single write. A page whose LSN is
+   * newer than the persistent LSN of the log is skipped; writing it would break write-ahead logging.
+   *
+   * @param target_clean_frames the number of frames that should be reusable without a write
+   * @return the number of pages written
+   */
+  auto CleanFrames(size_t target_clean_frames) -> size_t;
+
+  /** @brief Return the number of dirty victims written back synchronously while handing out a frame. */
+  auto GetForegroundWriteBacks() -> size_t { return stats_.Snapshot().dirty_write_backs_; }
+
+  /** @brief Return the hit, eviction, write-back and latch counters of this instance. */
+  auto GetStats() -> BufferPoolStatsSnapshot { return stats_.Snapshot(); }
+
+ private:
+  /**
+   * @brief Find a frame to hold a new page, first from the free list, then from the replacer and finally from the
+   * prefetched-but-unused frames. The write-back of a dirty victim is scheduled and the victim is removed from the
+   * page table. Caller must hold the latch, and may only reuse the frame's memory once the frame's pending I/O is done.
+   * @param[out] frame_id the frame that can be reused
+   * @return false if every frame is pinned
+   */
+  auto AcquireFrame(frame_id_t *frame_id) -> bool;
+
+  /**
+   * @brief Schedule the write of a frame's page without waiting for it, and mark the page clean. The write becomes the
+   * frame's pending I/O. Caller must hold the latch.
+   */
+  void ScheduleWriteBack(frame_id_t frame_id);
+
+  /**
+   * @brief Make loading a page into a frame the frame's pending I/O, so that fetches of the page wait for it. Caller
+   * must hold the latch, then release it and wait for the returned I/O before writing to the frame's memory.
+   * @param frame_id the frame the page is loaded into
+   * @param loaded the promise that is set once the page is loaded
+   * @return the I/O that was pending on the frame before, possibly invalid
+   */
+  auto BeginLoad(frame_id_t frame_id, std::promise<bool> *loaded) -> std::shared_future<bool>;
+
+  /** @return true if a read into or a write from the frame is still running. Caller must hold the latch. */
+  auto HasPendingIO(frame_id_t frame_id) const -> bool;
+
+  /**
+   * @brief Stop treating a frame as prefetched-but-unused. Caller must hold the latch.
+   * @return true if the frame was holding a prefetched page
+   */
+  auto ForgetPrefetched(frame_id_t frame_id) -> bool;
+
+  /** @brief Append a frame to the scan ring, trimming the ring back to its size. Caller must hold the latch. */
+  void AdmitToScanRing(frame_id_t frame_id);
+
+  /**
+   * @brief Take the oldest unpinned frame out of the scan ring, writing it back if dirty. Caller must hold the latch.
+   * @param[out] frame_id the frame that can be reused
+   * @return false if every frame in the ring is pinned
+   */
+  auto RecycleScanFrame(frame_id_t *frame_id) -> bool;
+
+  /** @brief Remove a frame from the scan ring if it is in there. Caller must hold the latch. */
+  void LeaveScanRing(frame_id_t frame_id);
+
+  /**
+   * @brief Evict the page of an unpinned frame beyond the pool size, writing it back if dirty, so that the frame can
+   * be dropped. Caller must hold the latch.
+   */
+  void RetireFrame(frame_id_t frame_id);
+
+  /** @return the metadata of a frame of this instance */
+  auto GetFrame(frame_id_t frame_id) -> Page * {
+    return &pages_[static_cast<size_t>(frame_id) * num_instances_ + instance_index_];
+  }
+
+  /** @return true if writing the page does not violate write-ahead logging. Caller must hold the latch. */
+  auto IsLogPersisted(Page *page) -> bool;
+
+  /**
+   * @brief Allocate a page on disk, reusing the lowest deallocated page id of this instance before growing the file.
+   * Caller should acquire the latch before calling this function, and sync the free-page map after releasing it if
+   * the id was reused.
+   * @param[out] reused whether the id was taken from the free-page map
+   * @return the id of the allocated page
+   */
+  auto AllocatePage(bool *reused) -> page_id_t;
+
+  /**
+   * @brief Deallocate a page on disk, recording it in the disk manager's free-page map. Caller should acquire the
+   * latch before calling this function.
+   * @param page_id id of the page to deallocate
+   */
+  void DeallocatePage(page_id_t page_id) { disk_scheduler_->GetDiskManager()->DeallocatePage(page_id); }
+
+  /** Number of frames owned by this instance; frame ids at or beyond it are never handed out. */
+  std::atomic<size_t> pool_size_;
+  /** Number of frames still known to this instance, larger than pool_size_ while a shrink is being drained. */
+  size_t num_frames_;
+  /** Number of instances in the parallel buffer pool. */
+  const uint32_t num_instances_;
+  /** Index of this instance in the parallel buffer pool. */
+  const uint32_t instance_index_;
+  /** The next page id to be allocated by this instance when no deallocated page can be reused. */
+  page_id_t next_page_id_;
+
+  /** Frames of the whole buffer pool; use GetFrame() to find the frames owned by this instance. */
+  Page *pages_;
+  /** Pointer to the disk scheduler shared by all instances. */
+  DiskScheduler *disk_scheduler_;
+  /** Pointer to the log manager. */
+  LogManager *log_manager_;
+  /** Page table for keeping track of the pages cached by this instance. */
+  std::unordered_map<page_id_t, frame_id_t> page_table_;
+  /** Replacer to find unpinned frames for replacement. */
+  std::unique_ptr<Replacer> replacer_;
+  /** List of free frames that don't have any pages on them. */
+  std::list<frame_id_t> free_list_;
+  /** Frames holding prefetched pages that have not been fetched yet, oldest first. */
+  std::list<frame_id_t> prefetched_;
+  /** Whether each frame is currently in prefetched_. */
+  std::vector<bool> is_prefetched_;
+  /** Upper bound on the size of prefetched_. */
+  size_t max_prefetched_{0};
+  /** Frames holding pages read by scans, oldest first. */
+  std::list<frame_id_t> scan_ring_;
+  /** Whether each frame is currently in scan_ring_. */
+  std::vector<bool> in_scan_ring_;
+  /** Upper bound on the size of scan_ring_; 0 = scans are not confined to a ring. */
+  size_t scan_ring_size_{0};
+  /**
+   * The last read into or write from every frame, which may still be running once the latch is released. I/O never
+   * runs under the latch: a page being read in is already in the page table, and a fetch of it waits for the read.
+   */
+  std::vector<std::shared_future<bool>> pending_io_;
+  /** The last read into every frame. A fetch hit only waits for this, not for a write of the page that is running. */
+  std::vector<std::shared_future<bool>> pending_load_;
+  /** Notified whenever a frame beyond the pool size is let go, see FetchPage(). */
+  std::condition_variable_any frame_retired_;
+  /** Frame at which the next CleanFrames call starts looking for dirty pages. */
+  size_t cleaner_hand_{0};
+  /** Hit, eviction and write-back counters and the latch histograms of this instance. */
+  BufferPoolStats stats_;
+  /**
+   * Protects the page table, the free, prefetched and scan ring lists, next_page_id_ and the metadata of the frames in
+   * this instance. Reports its wait and hold times to stats_.
+   */
+  InstrumentedMutex latch_{&stats_};
+};
+
+}  // namespace bustub
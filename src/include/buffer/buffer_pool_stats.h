@@ -0,0 +1,154 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.h
+//
+// Identification: src/include/buffer/buffer_pool_stats.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <mutex>  // NOLINT
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * An aggregated copy of the buffer pool counters. Latch times are kept as histograms with power-of-two buckets:
+ * bucket 0 counts samples below 1ns, bucket i counts samples in [2^(i-1), 2^i) ns, the last bucket everything above.
+ */
+struct BufferPoolStatsSnapshot {
+  static constexpr size_t NUM_BUCKETS = 40;
+  using Histogram = std::array<uint64_t, NUM_BUCKETS>;
+
+  /** Fetches served from a cached page. */
+  uint64_t hits_{0};
+  /** Fetches that had to read the page from disk. */
+  uint64_t misses_{0};
+  /** Frames taken from a resident page to make room for another. */
+  uint64_t evictions_{0};
+  /** Dirty victims written back by the thread that evicted them. */
+  uint64_t dirty_write_backs_{0};
+  /** NewPage and FetchPage requests that failed because every frame was pinned. */
+  uint64_t pin_waits_{0};
+  /** Time spent waiting for the instance latch. */
+  Histogram latch_wait_ns_{};
+  /** Time the instance latch was held. */
+  Histogram latch_hold_ns_{};
+
+  void Merge(const BufferPoolStatsSnapshot &other);
+
+  /** @return hits / (hits + misses), or 0 if nothing was fetched */
+  auto HitRatio() const -> double;
+
+  /** @return the upper bound in ns of the bucket holding the given percentile (0-100) of the histogram */
+  static auto Percentile(const Histogram &histogram, double percentile) -> uint64_t;
+
+  /** @return the number of samples in the histogram */
+  static auto Count(const Histogram &histogram) -> uint64_t;
+};
+
+/**
+ * BufferPoolStats collects the counters of one buffer pool instance. Every thread writes to its own cache-line aligned
+ * slot, so recording an event is an uncontended relaxed increment. Snapshot() sums all slots on demand.
+ */
+class BufferPoolStats {
+ public:
+  BufferPoolStats() = default;
+
+  DISALLOW_COPY_AND_MOVE(BufferPoolStats);
+
+  void RecordHit() { Add(&Slot::hits_); }
+  void RecordMiss() { Add(&Slot::misses_); }
+  void RecordEviction() { Add(&Slot::evictions_); }
+  void RecordDirtyWriteBack() { Add(&Slot::dirty_write_backs_); }
+  void RecordPinWait() { Add(&Slot::pin_waits_); }
+
+  void RecordLatchWait(uint64_t ns) {
+    LocalSlot().latch_wait_ns_[BucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+  }
+  void RecordLatchHold(uint64_t ns) {
+    LocalSlot().latch_hold_ns_[BucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /** @return the sum of all slots. Concurrent updates may or may not be included. */
+  auto Snapshot() const -> BufferPoolStatsSnapshot;
+
+  /** @return the histogram bucket of a sample */
+  static auto BucketOf(uint64_t ns) -> size_t;
+
+ private:
+  static constexpr size_t NUM_SLOTS = 64;
+
+  struct alignas(BUSTUB_CACHE_LINE_SIZE) Slot {
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evictions_{0};
+    std::atomic<uint64_t> dirty_write_backs_{0};
+    std::atomic<uint64_t> pin_waits_{0};
+    std::array<std::atomic<uint64_t>, BufferPoolStatsSnapshot::NUM_BUCKETS> latch_wait_ns_{};
+    std::array<std::atomic<uint64_t>, BufferPoolStatsSnapshot::NUM_BUCKETS> latch_hold_ns_{};
+  };
+
+  /** @return the slot of the calling thread; threads are assigned slots round robin on first use */
+  auto LocalSlot() -> Slot &;
+
+  void Add(std::atomic<uint64_t> Slot::*counter) { (LocalSlot().*counter).fetch_add(1, std::memory_order_relaxed); }
+
+  std::array<Slot, NUM_SLOTS> slots_;
+};
+
+/**
+ * A mutex that reports how long callers waited for it and how long they held it. It satisfies Lockable, so it works
+ * with std::scoped_lock and std::unique_lock like the std::mutex it replaces.
+ */
+class InstrumentedMutex {
+ public:
+  explicit InstrumentedMutex(BufferPoolStats *stats) : stats_(stats) {}
+
+  DISALLOW_COPY_AND_MOVE(InstrumentedMutex);
+
+  void lock() {  // NOLINT
+    auto start = std::chrono::steady_clock::now();
+    mutex_.lock();
+    acquired_at_ = std::chrono::steady_clock::now();
+    stats_->RecordLatchWait(ToNanos(acquired_at_ - start));
+  }
+
+  auto try_lock() -> bool {  // NOLINT
+    if (!mutex_.try_lock()) {
+      return false;
+    }
+    acquired_at_ = std::chrono::steady_clock::now();
+    stats_->RecordLatchWait(0);
+    return true;
+  }
+
+  void unlock() {  // NOLINT
+    auto held = std::chrono::steady_clock::now() - acquired_at_;
+    mutex_.unlock();
+    stats_->RecordLatchHold(ToNanos(held));
+  }
+
+ private:
+  static auto ToNanos(std::chrono::steady_clock::duration duration) -> uint64_t {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+  }
+
+  std::mutex mutex_;
+  BufferPoolStats *stats_;
+  /** When the current owner acquired the mutex; only touched by the owner. */
+  std::chrono::steady_clock::time_point acquired_at_;
+};
+
+}  // namespace bustub
@@ -23,6 +23,9 @@ namespace bustub {
 
 /**
  * ClockReplacer implements the clock replacement policy, which approximates the Least Recently Used policy.
+ *
+ * Every access sets the reference bit of a frame. The clock hand sweeps over the frames, clearing reference bits,
+ * and evicts the first evictable frame whose bit is already clear.
  */
 class ClockReplacer : public Replacer {
  public:
@@ -37,16 +40,43 @@ class ClockReplacer : public Replacer {
    */
   ~ClockReplacer() override;
 
-  auto Victim(frame_id_t *frame_id) -> bool override;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
-  void Pin(frame_id_t frame_id) override;
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                    page_id_t page_id = INVALID_PAGE_ID) override;
 
-  void Unpin(frame_id_t frame_id) override;
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
 
   auto Size() -> size_t override;
 
+  void Resize(size_t num_frames) override;
+
+  /** Evict a frame. Kept for the older Victim/Pin/Unpin interface. */
+  auto Victim(frame_id_t *frame_id) -> bool { return Evict(frame_id); }
+
+  /** Take a frame out of the replacer, e.g. because it was pinned. */
+  void Pin(frame_id_t frame_id);
+
+  /** Make a frame evictable, adding it to the replacer as just accessed if it is not in there yet. */
+  void Unpin(frame_id_t frame_id);
+
  private:
-  // TODO(student): implement me!
+  /** Take a frame out of the replacer. Caller must hold the latch. */
+  void Drop(frame_id_t frame_id);
+
+  /** Whether each frame is in the replacer. */
+  std::vector<bool> in_replacer_;
+  /** Whether each frame may be evicted. */
+  std::vector<bool> evictable_;
+  /** The reference bit of each frame, set on every access. */
+  std::vector<bool> referenced_;
+  /** The frame the clock hand points at. */
+  size_t hand_{0};
+  /** Number of evictable frames. */
+  size_t curr_size_{0};
+  std::mutex latch_;
 };
 
 }  // namespace bustub
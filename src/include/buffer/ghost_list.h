@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// ghost_list.h
+//
+// Identification: src/include/buffer/ghost_list.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * GhostList remembers the ids of recently evicted pages, oldest first, with constant time lookup. Replacers use it to
+ * recognize a page that is read back soon after it was evicted. The owner bounds its size with PopOldest().
+ */
+class GhostList {
+ public:
+  /** Add a page as the newest entry, moving it there if it is already in the list. */
+  void Push(page_id_t page_id) {
+    Erase(page_id);
+    index_.emplace(page_id, pages_.insert(pages_.end(), page_id));
+  }
+
+  /** @return true if the page was in the list and is now removed from it */
+  auto Erase(page_id_t page_id) -> bool {
+    auto it = index_.find(page_id);
+    if (it == index_.end()) {
+      return false;
+    }
+    pages_.erase(it->second);
+    index_.erase(it);
+    return true;
+  }
+
+  /** Forget the oldest entry, if any. */
+  void PopOldest() {
+    if (!pages_.empty()) {
+      index_.erase(pages_.front());
+      pages_.pop_front();
+    }
+  }
+
+  auto Size() const -> size_t { return pages_.size(); }
+
+ private:
+  /** The remembered page ids, oldest first. */
+  std::list<page_id_t> pages_;
+  /** Position of every remembered page id in pages_. */
+  std::unordered_map<page_id_t, std::list<page_id_t>::iterator> index_;
+};
+
+}  // namespace bustub
@@ -12,28 +12,61 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <limits>
 #include <list>
 #include <mutex>  // NOLINT
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "buffer/replacer.h"
 #include "common/config.h"
 #include "common/macros.h"
 
 namespace bustub {
 
-enum class AccessType { Unknown = 0, Get, Scan };
-
 class LRUKNode {
+ public:
+  LRUKNode(frame_id_t fid, size_t k) : k_(k), fid_(fid) {}
+
+  /**
+   * Add an access timestamp, dropping the oldest one once more than k are recorded. Hits are applied in batches, so
+   * the timestamp may be older than some already recorded; it is inserted in order.
+   */
+  void RecordAccess(size_t timestamp) {
+    auto pos = history_.end();
+    while (pos != history_.begin() && *std::prev(pos) > timestamp) {
+      --pos;
+    }
+    history_.insert(pos, timestamp);
+    if (history_.size() > k_) {
+      history_.pop_front();
+    }
+  }
+
+  /** @return true if the frame has fewer than k recorded accesses, i.e. its backward k-distance is +inf */
+  auto HasInfiniteDistance() const -> bool { return history_.size() < k_; }
+
+  /**
+   * @return the least recent timestamp in the history. For a frame with k accesses this is the k-th previous access,
+   * for a frame with fewer accesses it is the first access.
+   */
+  auto EarliestTimestamp() const -> size_t { return history_.front(); }
+
+  auto GetFrameId() const -> frame_id_t { return fid_; }
+
+  auto IsEvictable() const -> bool { return is_evictable_; }
+
+  void SetEvictable(bool set_evictable) { is_evictable_ = set_evictable; }
+
  private:
   /** History of last seen K timestamps of this page. Least recent timestamp stored in front. */
-  // Remove maybe_unused if you start using them. Feel free to change the member variables as you want.
-
-  [[maybe_unused]] std::list<size_t> history_;
-  [[maybe_unused]] size_t k_;
-  [[maybe_unused]] frame_id_t fid_;
-  [[maybe_unused]] bool is_evictable_{false};
+  std::list<size_t> history_;
+  size_t k_;
+  frame_id_t fid_;
+  bool is_evictable_{false};
 };
 
 /**
@@ -46,13 +79,15 @@ class LRUKNode {
  * A frame with less than k historical references is given
  * +inf as its backward k-distance. When multipe frames have +inf backward k-distance,
  * classical LRU algorithm is used to choose victim.
+ *
+ * Hits do not take the replacer latch: RecordHit stamps the access and appends it to one of LRUK_ACCESS_BUFFERS
+ * buffers, picked by thread id, and only a full buffer is applied under the latch. Evict and Remove apply all buffers
+ * first, so victims are the same as if every hit had been recorded right away, and a hit is never applied to a frame
+ * that was evicted and reused since.
  */
-class LRUKReplacer {
+class LRUKReplacer : public Replacer {
  public:
   /**
-   *
-   * TODO(P1): Add implementation
-   *
    * @brief a new LRUKReplacer.
    * @param num_frames the maximum number of frames the LRUReplacer will be required to store
    */
@@ -61,15 +96,11 @@ class LRUKReplacer {
   DISALLOW_COPY_AND_MOVE(LRUKReplacer);
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Destroys the LRUReplacer.
    */
-  ~LRUKReplacer() = default;
+  ~LRUKReplacer() override = default;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Find the frame with largest backward k-distance and evict that frame. Only frames
    * that are marked as 'evictable' are candidates for eviction.
    *
@@ -83,11 +114,9 @@ class LRUKReplacer {
    * @param[out] frame_id id of frame that is evicted.
    * @return true if a frame is evicted successfully, false if no frames can be evicted.
    */
-  auto Evict(frame_id_t *frame_id) -> bool;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Record the event that the given frame id is accessed at current timestamp.
    * Create a new entry for access history if frame id has not been seen before.
    *
@@ -97,12 +126,21 @@ class LRUKReplacer {
    * @param frame_id id of frame that received a new access.
    * @param access_type type of access that was received. This parameter is only needed for
    * leaderboard tests.
+   * @param page_id id of the page in the frame, ignored by LRU-K.
    */
-  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown);
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                    page_id_t page_id = INVALID_PAGE_ID) override;
+
+  /**
+   * @brief Record a hit on a pinned frame in the buffer of the calling thread, see the class comment.
+   * @param frame_id id of frame that received a new access.
+   * @param access_type ignored by LRU-K.
+   * @param page_id ignored by LRU-K.
+   */
+  void RecordHit(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                 page_id_t page_id = INVALID_PAGE_ID) override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Toggle whether a frame is evictable or non-evictable. This function also
    * controls replacer's size. Note that size is equal to number of evictable entries.
    *
@@ -117,11 +155,9 @@ class LRUKReplacer {
    * @param frame_id id of frame whose 'evictable' status will be modified
    * @param set_evictable whether the given frame is evictable or not
    */
-  void SetEvictable(frame_id_t frame_id, bool set_evictable);
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Remove an evictable frame from replacer, along with its access history.
    * This function should also decrement replacer's size if removal is successful.
    *
@@ -136,26 +172,38 @@ class LRUKReplacer {
    *
    * @param frame_id id of frame to be removed
    */
-  void Remove(frame_id_t frame_id);
+  void Remove(frame_id_t frame_id) override;
 
   /**
-   * TODO(P1): Add implementation
-   *
    * @brief Return replacer's size, which tracks the number of evictable frames.
    *
    * @return size_t
    */
-  auto Size() -> size_t;
+  auto Size() -> size_t override;
+
+  void Resize(size_t num_frames) override;
 
  private:
-  // TODO(student): implement me! You can replace these member variables as you like.
-  // Remove maybe_unused if you start using them.
-  [[maybe_unused]] std::unordered_map<frame_id_t, LRUKNode> node_store_;
-  [[maybe_unused]] size_t current_timestamp_{0};
-  [[maybe_unused]] size_t curr_size_{0};
-  [[maybe_unused]] size_t replacer_size_;
-  [[maybe_unused]] size_t k_;
-  [[maybe_unused]] std::mutex latch_;
+  /** Hits that have not been applied to the history yet, each with its timestamp. */
+  struct alignas(BUSTUB_CACHE_LINE_SIZE) AccessBuffer {
+    std::mutex latch_;
+    std::vector<std::pair<frame_id_t, size_t>> accesses_;
+  };
+
+  /** Apply the hits collected in a buffer; latch_ must be held. */
+  void ApplyAccessBuffer(AccessBuffer *buffer);
+
+  /** Apply the hits collected in all buffers; latch_ must be held. */
+  void ApplyAccessBuffers();
+
+  std::unordered_map<frame_id_t, LRUKNode> node_store_;
+  std::array<AccessBuffer, LRUK_ACCESS_BUFFERS> access_buffers_;
+  std::atomic<size_t> current_timestamp_{0};
+  size_t curr_size_{0};
+  size_t replacer_size_;
+  size_t k_;
+  /** Guards node_store_ and curr_size_; taken before the latch of an access buffer. */
+  std::mutex latch_;
 };
 
 }  // namespace bustub
@@ -22,7 +22,8 @@
 namespace bustub {
 
 /**
- * LRUReplacer implements the Least Recently Used replacement policy.
+ * LRUReplacer implements the Least Recently Used replacement policy: it evicts the evictable frame whose last access
+ * is the oldest.
  */
 class LRUReplacer : public Replacer {
  public:
@@ -37,16 +38,43 @@ class LRUReplacer : public Replacer {
    */
   ~LRUReplacer() override;
 
-  auto Victim(frame_id_t *frame_id) -> bool override;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
-  void Pin(frame_id_t frame_id) override;
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                    page_id_t page_id = INVALID_PAGE_ID) override;
 
-  void Unpin(frame_id_t frame_id) override;
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
 
   auto Size() -> size_t override;
 
+  void Resize(size_t num_frames) override;
+
+  /** Evict a frame. Kept for the older Victim/Pin/Unpin interface. */
+  auto Victim(frame_id_t *frame_id) -> bool { return Evict(frame_id); }
+
+  /** Take a frame out of the replacer, e.g. because it was pinned. */
+  void Pin(frame_id_t frame_id);
+
+  /** Make a frame evictable, adding it to the replacer as just accessed if it is not in there yet. */
+  void Unpin(frame_id_t frame_id);
+
  private:
-  // TODO(student): implement me!
+  /** Take a frame out of the replacer. Caller must hold the latch. */
+  void Drop(frame_id_t frame_id);
+
+  /** Frames in the replacer, least recently accessed first. */
+  std::list<frame_id_t> lru_list_;
+  /** Position of each frame in lru_list_, valid while in_replacer_ is set. */
+  std::vector<std::list<frame_id_t>::iterator> position_;
+  /** Whether each frame is in the replacer. */
+  std::vector<bool> in_replacer_;
+  /** Whether each frame may be evicted. */
+  std::vector<bool> evictable_;
+  /** Number of evictable frames. */
+  size_t curr_size_{0};
+  std::mutex latch_;
 };
 
 }  // namespace bustub
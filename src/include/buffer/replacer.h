@@ -12,12 +12,23 @@
 
 #pragma once
 
+#include <memory>
+
 #include "common/config.h"
 
 namespace bustub {
 
+enum class AccessType { Unknown = 0, Get, Scan };
+
+/** The replacement policies a buffer pool can be built with. */
+enum class ReplacerType { LRUK = 0, LRU, Clock, ARC, TwoQueue };
+
 /**
- * Replacer is an abstract class that tracks page usage.
+ * Replacer is an abstract class that tracks frame usage and picks the frame to evict when the buffer pool runs out of
+ * free frames.
+ *
+ * A frame enters the replacer with its first RecordAccess() and leaves it again through Evict() or Remove(). Only
+ * frames that are marked evictable may be picked by Evict(), and Size() counts those frames.
  */
 class Replacer {
  public:
@@ -25,26 +36,69 @@ class Replacer {
   virtual ~Replacer() = default;
 
   /**
-   * Remove the victim frame as defined by the replacement policy.
-   * @param[out] frame_id id of frame that was removed, nullptr if no victim was found
+   * @brief Create a replacer that implements the given policy.
+   * @param replacer_type the replacement policy
+   * @param num_frames the maximum number of frames the replacer will be required to store
+   * @param k the lookback constant k, only used by the LRU-K policy
+   */
+  static auto Create(ReplacerType replacer_type, size_t num_frames, size_t k) -> std::unique_ptr<Replacer>;
+
+  /**
+   * @brief Evict the victim frame as defined by the replacement policy, dropping what the replacer knows about it.
+   * @param[out] frame_id id of the frame that was evicted
    * @return true if a victim frame was found, false otherwise
    */
-  virtual auto Victim(frame_id_t *frame_id) -> bool = 0;
+  virtual auto Evict(frame_id_t *frame_id) -> bool = 0;
 
   /**
-   * Pins a frame, indicating that it should not be victimized until it is unpinned.
-   * @param frame_id the id of the frame to pin
+   * @brief Record an access to a frame. The first access after a frame entered the replacer means that a new page
+   * was loaded into it.
+   *
+   * @param frame_id id of the frame that was accessed
+   * @param access_type type of the access
+   * @param page_id id of the page held by the frame; policies that remember evicted pages (ARC, 2Q) use it to
+   * recognize a page that comes back, the others ignore it
    */
-  virtual void Pin(frame_id_t frame_id) = 0;
+  virtual void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                            page_id_t page_id = INVALID_PAGE_ID) = 0;
 
   /**
-   * Unpins a frame, indicating that it can now be victimized.
-   * @param frame_id the id of the frame to unpin
+   * @brief Record a buffer pool hit: an access to a frame that is in the replacer and pinned, and stays pinned until
+   * the call returns. Unlike the other calls it may run concurrently with Resize(). Policies may collect hits and
+   * apply them later, as long as Evict() and Remove() take them into account.
+   *
+   * @param frame_id id of the frame that was accessed
+   * @param access_type type of the access
+   * @param page_id id of the page held by the frame
    */
-  virtual void Unpin(frame_id_t frame_id) = 0;
+  virtual void RecordHit(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                         page_id_t page_id = INVALID_PAGE_ID) {
+    RecordAccess(frame_id, access_type, page_id);
+  }
 
-  /** @return the number of elements in the replacer that can be victimized */
+  /**
+   * @brief Toggle whether a frame may be evicted. Does nothing if the frame is not in the replacer.
+   * @param frame_id id of the frame
+   * @param set_evictable whether the frame is evictable
+   */
+  virtual void SetEvictable(frame_id_t frame_id, bool set_evictable) = 0;
+
+  /**
+   * @brief Remove an evictable frame from the replacer without treating it as an eviction, e.g. because its page was
+   * deleted. Does nothing if the frame is not in the replacer.
+   * @param frame_id id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) = 0;
+
+  /** @return the number of elements in the replacer that can be evicted */
   virtual auto Size() -> size_t = 0;
+
+  /**
+   * @brief Change the number of frames the replacer can track. Frames at or beyond the new size must not be in the
+   * replacer. Must not run concurrently with any other call but RecordHit().
+   * @param num_frames the new maximum number of frames
+   */
+  virtual void Resize(size_t num_frames) = 0;
 };
 
 }  // namespace bustub
@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_queue_replacer.h
+//
+// Identification: src/include/buffer/two_queue_replacer.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/ghost_list.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * TwoQueueReplacer implements the full 2Q replacement policy.
+ *
+ * A newly loaded page enters A1in, a FIFO queue; further accesses while it is in A1in are treated as correlated and
+ * ignored. When a page is evicted from A1in its id is remembered in the ghost queue A1out. A page that is read back
+ * while it is remembered in A1out has proven to be hot and goes to Am, an LRU list. Evict() takes frames from A1in
+ * while A1in holds more than a quarter of the frames, and the LRU frame of Am otherwise.
+ */
+class TwoQueueReplacer : public Replacer {
+ public:
+  /**
+   * @brief Create a new TwoQueueReplacer.
+   * @param num_frames the maximum number of frames the replacer will be required to store
+   */
+  explicit TwoQueueReplacer(size_t num_frames);
+
+  DISALLOW_COPY_AND_MOVE(TwoQueueReplacer);
+
+  ~TwoQueueReplacer() override = default;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                    page_id_t page_id = INVALID_PAGE_ID) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  void Resize(size_t num_frames) override;
+
+ private:
+  enum class ListId { None = 0, A1In, Am };
+
+  /** What the replacer knows about a frame. */
+  struct FrameEntry {
+    ListId list_{ListId::None};
+    std::list<frame_id_t>::iterator position_;
+    page_id_t page_id_{INVALID_PAGE_ID};
+    bool evictable_{false};
+  };
+
+  /** @return the list a frame in `list_id` lives in */
+  auto GetList(ListId list_id) -> std::list<frame_id_t> & { return list_id == ListId::A1In ? a1_in_ : am_; }
+
+  /** @return the oldest evictable frame of the list, or INVALID_FRAME_ID if there is none */
+  auto FindVictim(const std::list<frame_id_t> &list) const -> frame_id_t;
+
+  /** Move a frame to the back of a list. Caller must hold the latch. */
+  void MoveTo(frame_id_t frame_id, ListId list_id);
+
+  /** Take a frame out of A1in / Am. Caller must hold the latch. */
+  void Drop(frame_id_t frame_id);
+
+  static constexpr frame_id_t INVALID_FRAME_ID = -1;
+
+  std::vector<FrameEntry> frames_;
+  /** Frames whose page was loaded recently, oldest first. */
+  std::list<frame_id_t> a1_in_;
+  /** Frames whose page is hot, least recently used first. */
+  std::list<frame_id_t> am_;
+  /** Pages recently evicted from A1in. */
+  GhostList a1_out_;
+  /** A1in is preferred for eviction while it holds more than k_in_ frames. */
+  size_t k_in_;
+  /** A1out remembers at most k_out_ pages. */
+  size_t k_out_;
+  size_t curr_size_{0};
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -12,8 +12,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <thread>  // NOLINT
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -136,7 +138,7 @@ class Catalog {
     // When create_table_heap == false, it means that we're running binder tests (where no txn will be provided) or
     // we are running shell without buffer pool. We don't need to create TableHeap in this case.
     if (create_table_heap) {
-      table = std::make_unique<TableHeap>(bpm_, lock_manager_, log_manager_, txn);
+      table = std::make_unique<TableHeap>(bpm_, lock_manager_, log_manager_, txn, &schema);
     }
 
     // Fetch the table OID for the new table
@@ -228,12 +230,18 @@ class Catalog {
     // TODO(chi): support both hash index and btree index
     auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
 
-    // Populate the index with all tuples in table heap
+    // Populate the index with all tuples in table heap, loading them in key order. Every thread of the scan collects
+    // its own run of entries.
     auto *table_meta = GetTable(table_name);
     auto *heap = table_meta->table_.get();
-    for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
-      index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
-    }
+    const auto num_threads = heap->GetScanThreads(std::thread::hardware_concurrency());
+    std::vector<std::vector<std::pair<KeyType, ValueType>>> runs(num_threads);
+    heap->ParallelScan(num_threads, [&](size_t thread, const Tuple &tuple) {
+      KeyType index_key;
+      index_key.SetFromKey(tuple.KeyFromTuple(schema, key_schema, key_attrs));
+      runs[thread].emplace_back(index_key, tuple.GetRid());
+    });
+    index->BulkLoad(&runs, txn);
 
     // Get the next OID for the new index
     const auto index_oid = next_index_oid_.fetch_add(1);
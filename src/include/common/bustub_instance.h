@@ -47,6 +47,7 @@ class IndexStatement;
 class VariableSetStatement;
 class VariableShowStatement;
 class ExplainStatement;
+class VacuumStatement;
 
 class ResultWriter {
  public:
@@ -218,9 +219,10 @@ class BustubInstance {
   auto MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext>;
 
  public:
-  explicit BustubInstance(const std::string &db_file_name);
+  /** @param page_size the page size of the database, see DiskManager */
+  explicit BustubInstance(const std::string &db_file_name, size_t page_size = BUSTUB_PAGE_SIZE);
 
-  BustubInstance();
+  explicit BustubInstance(size_t page_size = BUSTUB_PAGE_SIZE);
 
   ~BustubInstance();
 
@@ -280,10 +282,12 @@ class BustubInstance {
   void CmdDisplayIndices(ResultWriter &writer);
   void CmdDisplayHelp(ResultWriter &writer);
   void WriteOneCell(const std::string &cell, ResultWriter &writer);
+  void DisplayBufferPoolStats(ResultWriter &writer);
 
   void HandleCreateStatement(Transaction *txn, const CreateStatement &stmt, ResultWriter &writer);
   void HandleIndexStatement(Transaction *txn, const IndexStatement &stmt, ResultWriter &writer);
   void HandleExplainStatement(Transaction *txn, const ExplainStatement &stmt, ResultWriter &writer);
+  void HandleVacuumStatement(Transaction *txn, const VacuumStatement &stmt, ResultWriter &writer);
   void HandleVariableShowStatement(Transaction *txn, const VariableShowStatement &stmt, ResultWriter &writer);
   void HandleVariableSetStatement(Transaction *txn, const VariableSetStatement &stmt, ResultWriter &writer);
 
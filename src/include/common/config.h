@@ -27,15 +27,34 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** The buffer pool page cleaner wakes up every page_cleaner_interval milliseconds. */
+extern std::chrono::milliseconds page_cleaner_interval;
+
 static constexpr int INVALID_PAGE_ID = -1;                                           // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                            // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                               // invalid log sequence number
 static constexpr int HEADER_PAGE_ID = 0;                                             // the header page id
-static constexpr int BUSTUB_PAGE_SIZE = 4096;                                        // size of a data page in byte
+static constexpr int BUSTUB_PAGE_SIZE = 4096;                                        // default data page size in byte
+static constexpr int BUSTUB_MAX_PAGE_SIZE = 65536;                                   // largest configurable page size
+static constexpr int BUSTUB_PAGE_ALIGNMENT = 4096;                                   // alignment of page buffers
+static constexpr int BUSTUB_CACHE_LINE_SIZE = 64;                                    // size of a cache line in byte
+static constexpr int BUSTUB_HUGE_PAGE_SIZE = 2 * 1024 * 1024;                        // size of a transparent huge page
 static constexpr int BUFFER_POOL_SIZE = 10;                                          // size of buffer pool
+static constexpr int BUFFER_POOL_INSTANCES = 1;  // number of buffer pool instances (shards)
+static constexpr int BUFFER_POOL_MAX_SIZE = 1 << 18;  // frames of address space reserved for growing the pool
+static constexpr int READ_AHEAD_WINDOW = 0;      // pages read ahead of a table scan, 0 = disabled
+static constexpr int SCAN_RING_SIZE = 0;         // frames that scans recycle among, 0 = disabled
+static constexpr int CLEAN_FRAME_TARGET = 25;    // percentage of frames the page cleaner keeps clean
+static constexpr int RESIZE_POOL_TIMEOUT_MS = 10000;  // how long a shrink waits for pinned frames to be unpinned
+static constexpr int RETIRING_FRAME_WAIT_MS = 100;    // how long a fetch waits for a frame a shrink lets go of
+static constexpr int DISK_SCHEDULER_WORKERS = 4;  // number of threads running disk requests
+static constexpr int MAX_COALESCED_WRITE = 64;    // pages merged into a single vectored write
+static constexpr int OVERFLOW_THRESHOLD_RATIO = 8;  // varchars longer than page_size / this go to overflow pages
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr int LRUK_ACCESS_BUFFERS = 16;      // buffers that collect lru-k hits, picked by thread id
+static constexpr int LRUK_ACCESS_BUFFER_SIZE = 64;  // hits a buffer collects before they are applied
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
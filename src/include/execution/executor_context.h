@@ -23,6 +23,7 @@
 #include "execution/check_options.h"
 #include "execution/executors/abstract_executor.h"
 #include "storage/page/tmp_tuple_page.h"
+#include "type/arena_pool.h"
 
 namespace bustub {
 class AbstractExecutor;
@@ -74,6 +75,12 @@ class ExecutorContext {
     return nlj_check_exec_set_;
   }
 
+  /**
+   * @return the arena of this query. Tuples, varchar values and hash table entries that only live as long as the
+   * query are allocated from it, and freed all at once with the context.
+   */
+  auto GetArena() -> ArenaPool * { return &arena_; }
+
   /** @return the check options */
   auto GetCheckOptions() -> std::shared_ptr<CheckOptions> { return check_options_; }
 
@@ -101,6 +108,8 @@ class ExecutorContext {
   std::deque<std::pair<AbstractExecutor *, AbstractExecutor *>> nlj_check_exec_set_;
   /** The set of check options associated with this executor context */
   std::shared_ptr<CheckOptions> check_options_;
+  /** The memory of the query */
+  ArenaPool arena_;
 };
 
 }  // namespace bustub
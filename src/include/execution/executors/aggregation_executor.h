@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <utility>
@@ -24,6 +25,7 @@
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/aggregation_plan.h"
 #include "storage/table/tuple.h"
+#include "type/arena_pool.h"
 #include "type/value_factory.h"
 
 namespace bustub {
@@ -32,15 +34,20 @@ namespace bustub {
  * A simplified hash table that has all the necessary functionality for aggregations.
  */
 class SimpleAggregationHashTable {
+  using HashTable =
+      std::unordered_map<AggregateKey, AggregateValue, std::hash<AggregateKey>, std::equal_to<AggregateKey>,
+                         ArenaAllocator<std::pair<const AggregateKey, AggregateValue>>>;
+
  public:
   /**
    * Construct a new SimpleAggregationHashTable instance.
    * @param agg_exprs the aggregation expressions
    * @param agg_types the types of aggregations
+   * @param arena the arena of the query that the entries are allocated from, or nullptr to use the heap
    */
   SimpleAggregationHashTable(const std::vector<AbstractExpressionRef> &agg_exprs,
-                             const std::vector<AggregationType> &agg_types)
-      : agg_exprs_{agg_exprs}, agg_types_{agg_types} {}
+                             const std::vector<AggregationType> &agg_types, ArenaPool *arena = nullptr)
+      : ht_{HashTable::allocator_type{arena}}, agg_exprs_{agg_exprs}, agg_types_{agg_types} {}
 
   /** @return The initial aggregate value for this aggregation executor */
   auto GenerateInitialAggregateValue() -> AggregateValue {
@@ -104,7 +111,7 @@ class SimpleAggregationHashTable {
   class Iterator {
    public:
     /** Creates an iterator for the aggregate map. */
-    explicit Iterator(std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter) : iter_{iter} {}
+    explicit Iterator(HashTable::const_iterator iter) : iter_{iter} {}
 
     /** @return The key of the iterator */
     auto Key() -> const AggregateKey & { return iter_->first; }
@@ -126,7 +133,7 @@ class SimpleAggregationHashTable {
 
    private:
     /** Aggregates map */
-    std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter_;
+    HashTable::const_iterator iter_;
   };
 
   /** @return Iterator to the start of the hash table */
@@ -137,7 +144,7 @@ class SimpleAggregationHashTable {
 
  private:
   /** The hash table is just a map from aggregate keys to aggregate values */
-  std::unordered_map<AggregateKey, AggregateValue> ht_{};
+  HashTable ht_;
   /** The aggregate expressions that we have */
   const std::vector<AbstractExpressionRef> &agg_exprs_;
   /** The types of aggregations that we have */
@@ -16,28 +16,50 @@
 #include <fstream>
 #include <future>  // NOLINT
 #include <mutex>   // NOLINT
+#include <set>
 #include <string>
+#include <vector>
 
 #include "common/config.h"
+#include "storage/disk/free_page_map.h"
 
 namespace bustub {
 
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ *
+ * Pages are read and written with positional I/O (`pread`/`pwrite`), so ReadPage and WritePage may be called
+ * concurrently, e.g. by the workers of a DiskScheduler. Optionally the db file is opened with `O_DIRECT`, which skips
+ * the OS page cache; page buffers that are not aligned to BUSTUB_PAGE_ALIGNMENT then go through a bounce buffer.
+ *
+ * The page size is a property of the database: a power of two between BUSTUB_PAGE_SIZE and BUSTUB_MAX_PAGE_SIZE that
+ * every buffer pool on top of this disk manager uses for its frames. It is recorded when the database is created, and
+ * opening the database with a different page size throws.
+ *
+ * Deallocated pages are tracked in a FreePageMap that is kept next to the database file (`<name>.fpm`: the page size
+ * as a 64-bit word, then one 64-bit word of the bitmap after the other). Changes only mark their word dirty;
+ * SyncFreePageMap writes the dirty words and syncs the file once. The buffer pool syncs after reusing a page id and
+ * before handing the page out, so a page id is never reused twice after a crash; a free that was not synced yet at
+ * worst leaves the page unused. The file is never shrunk, trailing free pages stay in the db file until they are
+ * reused. The map of an empty database file is discarded when the file is opened, since it can only be left over from
+ * an earlier database.
  */
 class DiskManager {
  public:
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param direct_io whether to open the database file with O_DIRECT; falls back to buffered I/O if the file system
+   * does not support it
+   * @param page_size the size of a page in bytes, must match the page size the database was created with
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, bool direct_io = false, size_t page_size = BUSTUB_PAGE_SIZE);
 
   /** FOR TEST / LEADERBOARD ONLY, used by DiskManagerMemory */
-  DiskManager() = default;
+  explicit DiskManager(size_t page_size = BUSTUB_PAGE_SIZE);
 
-  virtual ~DiskManager() = default;
+  virtual ~DiskManager();
 
   /**
    * Shut down the disk manager and close all the file resources.
@@ -51,6 +73,13 @@ class DiskManager {
    */
   virtual void WritePage(page_id_t page_id, const char *page_data);
 
+  /**
+   * Write a run of pages with consecutive page ids to the database file, using as few `pwritev` calls as possible.
+   * @param page_id id of the first page
+   * @param pages raw data of the pages, one entry per page
+   */
+  virtual void WritePages(page_id_t page_id, const std::vector<const char *> &pages);
+
   /**
    * Read a page from the database file.
    * @param page_id id of the page
@@ -58,6 +87,31 @@ class DiskManager {
    */
   virtual void ReadPage(page_id_t page_id, char *page_data);
 
+  /**
+   * Take a deallocated page id for reuse, lowest first. Only ids with `page_id % num_stripes == stripe` are considered,
+   * so that every buffer pool instance draws from the ids it owns.
+   * @return the page id, or INVALID_PAGE_ID if no page of the stripe is free
+   */
+  virtual auto AllocateFreePage(uint32_t num_stripes = 1, uint32_t stripe = 0) -> page_id_t;
+
+  /**
+   * Deallocate a page, so that AllocateFreePage hands its id out again.
+   * @param page_id id of the page
+   */
+  virtual void DeallocatePage(page_id_t page_id);
+
+  /**
+   * Write the words of the free-page map changed since the last call to the .fpm file and sync it. Called by the
+   * buffer pool outside of its latches; ShutDown and the destructor sync as well.
+   */
+  virtual void SyncFreePageMap();
+
+  /** @return the number of deallocated pages waiting to be reused */
+  virtual auto GetNumFreePages() -> size_t;
+
+  /** @return one past the highest page id that was in use when the database file was opened */
+  virtual auto GetNumPages() const -> page_id_t { return num_pages_; }
+
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
@@ -83,6 +137,12 @@ class DiskManager {
   /** @return the number of disk writes */
   auto GetNumWrites() const -> int;
 
+  /** @return true iff the database file is accessed with O_DIRECT */
+  auto IsDirectIO() const -> bool { return direct_io_; }
+
+  /** @return the size of a page in bytes */
+  auto GetPageSize() const -> size_t { return page_size_; }
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -93,19 +153,33 @@ class DiskManager {
   inline auto HasFlushLogFuture() -> bool { return flush_log_f_ != nullptr; }
 
  protected:
+  // bytes in front of the bitmap in the .fpm file, which hold the page size
+  static constexpr size_t FPM_HEADER_SIZE = sizeof(uint64_t);
   auto GetFileSize(const std::string &file_name) -> int;
+  // positional read / write of exactly one page, retrying short transfers
+  void ReadPageAt(page_id_t page_id, char *page_data);
+  void WritePageAt(page_id_t page_id, const char *page_data);
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
-  // stream to write db file
-  std::fstream db_io_;
+  // descriptor of the db file, accessed with positional I/O only
+  int db_fd_{-1};
+  bool direct_io_{false};
+  // size of every page in the database file
+  size_t page_size_{BUSTUB_PAGE_SIZE};
+  // deallocated pages, persisted in fpm_fd_ if the database lives in a file
+  FreePageMap free_pages_;
+  std::mutex free_pages_latch_;
+  // words of free_pages_ changed since the last SyncFreePageMap, guarded by free_pages_latch_
+  std::set<size_t> dirty_words_;
+  std::mutex fpm_sync_latch_;
+  int fpm_fd_{-1};
+  page_id_t num_pages_{0};
   std::string file_name_;
   int num_flushes_{0};
-  int num_writes_{0};
+  std::atomic<int> num_writes_{0};
   bool flush_log_{false};
   std::future<void> *flush_log_f_{nullptr};
-  // With multiple buffer pool instances, need to protect file access
-  std::mutex db_io_latch_;
 };
 
 }  // namespace bustub
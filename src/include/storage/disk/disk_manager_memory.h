@@ -35,7 +35,7 @@ namespace bustub {
  */
 class DiskManagerMemory : public DiskManager {
  public:
-  explicit DiskManagerMemory(size_t pages);
+  explicit DiskManagerMemory(size_t pages, size_t page_size = BUSTUB_PAGE_SIZE);
 
   ~DiskManagerMemory() override { delete[] memory_; }
 
@@ -46,6 +46,13 @@ class DiskManagerMemory : public DiskManager {
    */
   void WritePage(page_id_t page_id, const char *page_data) override;
 
+  /**
+   * Write a run of pages with consecutive page ids, one page at a time.
+   * @param page_id id of the first page
+   * @param pages raw data of the pages
+   */
+  void WritePages(page_id_t page_id, const std::vector<const char *> &pages) override;
+
   /**
    * Read a page from the database file.
    * @param page_id id of the page
@@ -63,7 +70,7 @@ class DiskManagerMemory : public DiskManager {
  */
 class DiskManagerUnlimitedMemory : public DiskManager {
  public:
-  DiskManagerUnlimitedMemory() = default;
+  explicit DiskManagerUnlimitedMemory(size_t page_size = BUSTUB_PAGE_SIZE) : DiskManager(page_size) {}
 
   /**
    * Write a page to the database file.
@@ -81,12 +88,24 @@ class DiskManagerUnlimitedMemory : public DiskManager {
     }
     if (data_[page_id] == nullptr) {
       data_[page_id] = std::make_shared<ProtectedPage>();
+      data_[page_id]->first.resize(page_size_);
     }
     std::shared_ptr<ProtectedPage> ptr = data_[page_id];
     std::unique_lock<std::shared_mutex> l_page(ptr->second);
     l.unlock();
 
-    memcpy(ptr->first.data(), page_data, BUSTUB_PAGE_SIZE);
+    memcpy(ptr->first.data(), page_data, page_size_);
+  }
+
+  /**
+   * Write a run of pages with consecutive page ids, one page at a time.
+   * @param page_id id of the first page
+   * @param pages raw data of the pages
+   */
+  void WritePages(page_id_t page_id, const std::vector<const char *> &pages) override {
+    for (size_t i = 0; i < pages.size(); ++i) {
+      WritePage(page_id + static_cast<page_id_t>(i), pages[i]);
+    }
   }
 
   /**
@@ -112,14 +131,26 @@ class DiskManagerUnlimitedMemory : public DiskManager {
     std::shared_lock<std::shared_mutex> l_page(ptr->second);
     l.unlock();
 
-    memcpy(page_data, ptr->first.data(), BUSTUB_PAGE_SIZE);
+    memcpy(page_data, ptr->first.data(), page_size_);
+  }
+
+  /**
+   * Deallocate a page and release its memory.
+   * @param page_id id of the page
+   */
+  void DeallocatePage(page_id_t page_id) override {
+    DiskManager::DeallocatePage(page_id);
+    std::unique_lock<std::mutex> l(mutex_);
+    if (page_id >= 0 && page_id < static_cast<int>(data_.size())) {
+      data_[page_id] = nullptr;
+    }
   }
 
   void SetLatency(size_t latency_ms) { latency_ = latency_ms; }
 
  private:
   std::mutex mutex_;
-  using Page = std::array<char, BUSTUB_PAGE_SIZE>;
+  using Page = std::vector<char>;
   using ProtectedPage = std::pair<Page, std::shared_mutex>;
   std::vector<std::shared_ptr<ProtectedPage>> data_;
   size_t latency_{0};
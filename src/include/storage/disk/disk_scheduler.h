@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler.h
+//
+// Identification: src/include/storage/disk/disk_scheduler.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <future>  // NOLINT
+#include <memory>
+#include <optional>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/channel.h"
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * @brief Represents a Write or Read request for the DiskManager to execute.
+ */
+struct DiskRequest {
+  /** Flag indicating whether the request is a write or a read. */
+  bool is_write_;
+
+  /**
+   *  Pointer to the start of the memory location where a page is either:
+   *   1. being read into from disk (on a read).
+   *   2. being written out to disk (on a write).
+   */
+  char *data_;
+
+  /** ID of the page being read from / written to disk. */
+  page_id_t page_id_;
+
+  /** Callback used to signal to the request issuer when the request has been completed. */
+  std::promise<bool> callback_;
+
+  /** For a vectored write: data of the pages following page_id_, written in the same call. */
+  std::vector<char *> next_data_{};
+};
+
+/**
+ * @brief The DiskScheduler schedules disk read and write operations.
+ *
+ * A request is scheduled by calling DiskScheduler::Schedule() with an appropriate DiskRequest object. The scheduler
+ * runs the requests on a pool of worker threads, so requests for different pages proceed in parallel. All requests
+ * for the same page are handled by the same worker in the order they were scheduled, so a read always observes the
+ * writes scheduled before it.
+ */
+class DiskScheduler {
+ public:
+  /**
+   * @brief Creates a new DiskScheduler and starts its workers.
+   * @param disk_manager the disk manager that performs the I/O
+   * @param num_workers the number of worker threads, at least one
+   */
+  explicit DiskScheduler(DiskManager *disk_manager, size_t num_workers = DISK_SCHEDULER_WORKERS);
+
+  /** @brief Stops the workers after they have drained their queues. */
+  ~DiskScheduler();
+
+  /**
+   * @brief Schedules a request for the DiskManager to execute.
+   *
+   * @param r The request to be scheduled.
+   */
+  void Schedule(DiskRequest r);
+
+  /**
+   * @brief Create a Promise object. If you want to implement your own version of promise, you can change this
+   * function so that our test cases can use your promise implementation.
+   *
+   * @return std::promise<bool>
+   */
+  auto CreatePromise() -> std::promise<bool> { return {}; };
+
+  /**
+   * @brief Schedule a read of a page and wait for it to complete.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data);
+
+  /**
+   * @brief Schedule a write of a page and wait for it to complete.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  void WritePage(page_id_t page_id, const char *page_data);
+
+  /**
+   * @brief Schedule a write of a page without waiting for it.
+   * @param page_id id of the page
+   * @param page_data raw page data, which must stay unchanged until the write completes
+   * @return the future that is set once the page is written
+   */
+  auto ScheduleWrite(page_id_t page_id, const char *page_data) -> std::future<bool>;
+
+  /**
+   * @brief Write a batch of pages and wait for all of them to complete.
+   *
+   * The pages are sorted by page id and each run of consecutive page ids is written with a single vectored write,
+   * capped at MAX_COALESCED_WRITE pages. A run is handled by the worker of its first page, so the caller must not
+   * schedule other requests for these pages until this call returns.
+   *
+   * @param pages the id and data of every page to write
+   */
+  void WritePages(std::vector<std::pair<page_id_t, char *>> pages);
+
+  /** @brief Return the disk manager the requests are executed on. */
+  auto GetDiskManager() -> DiskManager * { return disk_manager_; }
+
+ private:
+  /** @brief Body of a worker thread: processes the requests of its queue until it receives std::nullopt. */
+  void StartWorkerThread(size_t worker);
+
+  /** Pointer to the disk manager. */
+  DiskManager *disk_manager_;
+  /** One queue per worker; a request is routed to the queue of the worker owning its page id. */
+  std::vector<std::unique_ptr<Channel<std::optional<DiskRequest>>>> request_queues_;
+  /** The worker threads, one per queue. */
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace bustub
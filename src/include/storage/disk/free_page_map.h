@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_page_map.h
+//
+// Identification: src/include/storage/disk/free_page_map.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * FreePageMap is a bitmap over the page ids of a database file: bit `i` of word `i / 64` is set iff page `i` has been
+ * deallocated and may be handed out again. Pages are reused lowest id first, so the live pages stay packed at the
+ * front of the file. The word layout is also the on-disk format, see DiskManager. Not thread-safe.
+ */
+class FreePageMap {
+ public:
+  static constexpr size_t BITS_PER_WORD = 64;
+
+  FreePageMap() = default;
+
+  /** @brief Mark a page as free. Freeing a free page has no effect. */
+  void Free(page_id_t page_id);
+
+  /**
+   * @brief Take the lowest free page id with `page_id % num_stripes == stripe` and mark it as in use.
+   * @return the page id, or INVALID_PAGE_ID if no page of the stripe is free
+   */
+  auto Take(uint32_t num_stripes = 1, uint32_t stripe = 0) -> page_id_t;
+
+  /** @return true if the page is free */
+  auto IsFree(page_id_t page_id) const -> bool;
+
+  /** @return the number of free pages */
+  auto GetNumFree() const -> size_t { return num_free_; }
+
+  /** @return one past the highest free page id, 0 if no page is free */
+  auto GetEnd() const -> page_id_t;
+
+  /** @return the index of the word holding the bit of a page */
+  static auto WordOf(page_id_t page_id) -> size_t { return static_cast<size_t>(page_id) / BITS_PER_WORD; }
+
+  /** @return the words of the bitmap */
+  auto GetWords() const -> const std::vector<uint64_t> & { return words_; }
+
+  /** @brief Replace the bitmap, e.g. with the words read back from disk. */
+  void Load(std::vector<uint64_t> words);
+
+ private:
+  std::vector<uint64_t> words_;
+  /** Number of set bits in words_. */
+  size_t num_free_{0};
+  /** Every word below this one is zero. */
+  size_t first_word_{0};
+};
+
+}  // namespace bustub
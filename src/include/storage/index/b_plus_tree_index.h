@@ -14,6 +14,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "container/hash/hash_function.h"
@@ -35,6 +36,16 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  /**
+   * Load the entries of a table into the empty index. The entries are sorted by key first, so that every insert goes
+   * to the rightmost leaf: the path it descends is already in the buffer pool, and the leaves are filled one after
+   * the other instead of being split all over the tree.
+   * @param runs the (key, rid) pairs to load, in runs that are sorted in place by one thread each and then merged;
+   * entries with equal keys are loaded in the order of their runs and of their positions in a run
+   * @param transaction the transaction building the index
+   */
+  void BulkLoad(std::vector<std::vector<std::pair<KeyType, ValueType>>> *runs, Transaction *transaction);
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
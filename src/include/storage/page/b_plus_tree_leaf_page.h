@@ -20,7 +20,8 @@ namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
 #define LEAF_PAGE_HEADER_SIZE 16
-#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+#define LEAF_PAGE_SLOT_CNT(page_size) (((page_size)-LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+#define LEAF_PAGE_SIZE LEAF_PAGE_SLOT_CNT(BUSTUB_PAGE_SIZE)
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// overflow_page.h
+//
+// Identification: src/include/storage/page/overflow_page.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * An overflow page holds a piece of a varchar value that is too large to be kept in its tuple. The pieces of a value
+ * are chained in order, see OverflowStore.
+ *
+ * Format (sizes in bytes):
+ * ----------------------------------------------------------
+ * | NextPageId (4) | PieceSize (4) | Piece (page_size - 8) |
+ * ----------------------------------------------------------
+ */
+class OverflowPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  OverflowPage() = delete;
+  OverflowPage(const OverflowPage &other) = delete;
+
+  static constexpr size_t HEADER_SIZE = sizeof(page_id_t) + sizeof(uint32_t);
+
+  /** @return the bytes of a value an overflow page of the given size holds */
+  static constexpr auto Capacity(size_t page_size) -> size_t { return page_size - HEADER_SIZE; }
+
+  void Init(page_id_t next_page_id, const char *piece, uint32_t piece_size) {
+    next_page_id_ = next_page_id;
+    piece_size_ = piece_size;
+    memcpy(piece_, piece, piece_size);
+  }
+
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
+  auto GetPieceSize() const -> uint32_t { return piece_size_; }
+  auto GetPiece() const -> const char * { return piece_; }
+
+ private:
+  page_id_t next_page_id_;
+  uint32_t piece_size_;
+  char piece_[0];
+};
+
+}  // namespace bustub
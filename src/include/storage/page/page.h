@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
 
@@ -24,24 +25,32 @@ namespace bustub {
  * Page is the basic unit of storage within the database system. Page provides a wrapper for actual data pages being
  * held in main memory. Page also contains book-keeping information that is used by the buffer pool manager, e.g.
  * pin count, dirty flag, page id, etc.
+ *
+ * The data itself is not owned by the Page: the buffer pool points every Page into its frame arena. Pages are
+ * aligned to a cache line so that the metadata of neighbouring frames never share one.
+ *
+ * Besides the latch, a page has a version that writers bump when they take and release the write latch, so it is odd
+ * while the page is being written. A reader may read a pinned page without latching it (ReadVersion, read, then
+ * ValidateVersion), as long as it copes with torn data and throws away whatever it read if validation fails.
  */
-class Page {
+class alignas(BUSTUB_CACHE_LINE_SIZE) Page {
   // There is book-keeping information inside the page that should only be relevant to the buffer pool manager.
   friend class BufferPoolManager;
+  friend class BufferPoolManagerInstance;
 
  public:
-  /** Constructor. Zeros out the page data. */
-  Page() {
-    data_ = new char[BUSTUB_PAGE_SIZE];
-    ResetMemory();
-  }
+  /** Constructor. The page has no data until the buffer pool assigns it a frame. */
+  Page() = default;
 
   /** Default destructor. */
-  ~Page() { delete[] data_; }
+  ~Page() = default;
 
   /** @return the actual data contained within this page */
   inline auto GetData() -> char * { return data_; }
 
+  /** @return the size of the data in bytes, the page size of the database */
+  inline auto GetPageSize() -> size_t { return page_size_; }
+
   /** @return the page id of this page */
   inline auto GetPageId() -> page_id_t { return page_id_; }
 
@@ -52,10 +61,18 @@ class Page {
   inline auto IsDirty() -> bool { return is_dirty_; }
 
   /** Acquire the page write latch. */
-  inline void WLatch() { rwlatch_.WLock(); }
+  inline void WLatch() {
+    rwlatch_.WLock();
+    version_.fetch_add(1, std::memory_order_relaxed);
+    // Keep the writes to the data after the version turned odd.
+    std::atomic_thread_fence(std::memory_order_release);
+  }
 
   /** Release the page write latch. */
-  inline void WUnlatch() { rwlatch_.WUnlock(); }
+  inline void WUnlatch() {
+    version_.fetch_add(1, std::memory_order_release);
+    rwlatch_.WUnlock();
+  }
 
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
@@ -63,6 +80,16 @@ class Page {
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
+  /** @return the version to validate an optimistic read against; odd if a writer holds the write latch */
+  inline auto ReadVersion() const -> uint64_t { return version_.load(std::memory_order_acquire); }
+
+  /** @return true if no writer latched the page since ReadVersion returned version, so what was read is consistent */
+  inline auto ValidateVersion(uint64_t version) const -> bool {
+    // Keep the reads of the data before the version check.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return (version & 1) == 0 && version_.load(std::memory_order_relaxed) == version;
+  }
+
   /** @return the page LSN. */
   inline auto GetLSN() -> lsn_t { return *reinterpret_cast<lsn_t *>(GetData() + OFFSET_LSN); }
 
@@ -79,12 +106,12 @@ class Page {
 
  private:
   /** Zeroes out the data that is held within the page. */
-  inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, BUSTUB_PAGE_SIZE); }
+  inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, page_size_); }
 
-  /** The actual data that is stored within a page. */
-  // Usually this should be stored as `char data_[BUSTUB_PAGE_SIZE]{};`. But to enable ASAN to detect page overflow,
-  // we store it as a ptr.
-  char *data_;
+  /** The actual data that is stored within a page; page_size_ bytes of the buffer pool's frame arena. */
+  char *data_{nullptr};
+  /** The size of data_ in bytes. */
+  size_t page_size_{BUSTUB_PAGE_SIZE};
   /** The ID of this page. */
   page_id_t page_id_ = INVALID_PAGE_ID;
   /** The pin count of this page. */
@@ -93,6 +120,8 @@ class Page {
   bool is_dirty_ = false;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /** Bumped by WLatch and WUnlatch, for optimistic readers. */
+  std::atomic<uint64_t> version_{0};
 };
 
 }  // namespace bustub
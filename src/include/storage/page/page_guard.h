@@ -15,8 +15,7 @@ class BasicPageGuard {
   BasicPageGuard(const BasicPageGuard &) = delete;
   auto operator=(const BasicPageGuard &) -> BasicPageGuard & = delete;
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Move constructor for BasicPageGuard
    *
    * When you call BasicPageGuard(std::move(other_guard)), you
@@ -27,8 +26,7 @@ class BasicPageGuard {
    */
   BasicPageGuard(BasicPageGuard &&that) noexcept;
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Drop a page guard
    *
    * Dropping a page guard should clear all contents
@@ -38,8 +36,7 @@ class BasicPageGuard {
    */
   void Drop();
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Move assignment for BasicPageGuard
    *
    * Similar to a move constructor, except that the move
@@ -50,8 +47,7 @@ class BasicPageGuard {
    */
   auto operator=(BasicPageGuard &&that) noexcept -> BasicPageGuard &;
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Destructor for BasicPageGuard
    *
    * When a page guard goes out of scope, it should behave as if
@@ -82,20 +78,30 @@ class BasicPageGuard {
   friend class ReadPageGuard;
   friend class WritePageGuard;
 
-  [[maybe_unused]] BufferPoolManager *bpm_{nullptr};
+  BufferPoolManager *bpm_{nullptr};
   Page *page_{nullptr};
   bool is_dirty_{false};
 };
 
+/**
+ * A guard that holds a page pinned and read-latched.
+ *
+ * In optimistic mode (see BufferPoolManager::FetchPageOptimistic) the guard only holds the pin and the version the
+ * page had when the guard was taken. Reads through it may see a concurrent writer's half-done changes; Validate tells
+ * whether they did, and Latch turns the guard into a regular one.
+ */
 class ReadPageGuard {
  public:
   ReadPageGuard() = default;
   ReadPageGuard(BufferPoolManager *bpm, Page *page) : guard_(bpm, page) {}
+  ReadPageGuard(BufferPoolManager *bpm, Page *page, bool is_optimistic)
+      : guard_(bpm, page),
+        is_optimistic_(is_optimistic && page != nullptr),
+        version_(is_optimistic_ ? page->ReadVersion() : 0) {}
   ReadPageGuard(const ReadPageGuard &) = delete;
   auto operator=(const ReadPageGuard &) -> ReadPageGuard & = delete;
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Move constructor for ReadPageGuard
    *
    * Very similar to BasicPageGuard. You want to create
@@ -104,8 +110,7 @@ class ReadPageGuard {
    */
   ReadPageGuard(ReadPageGuard &&that) noexcept;
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Move assignment for ReadPageGuard
    *
    * Very similar to BasicPageGuard. Given another ReadPageGuard,
@@ -113,8 +118,7 @@ class ReadPageGuard {
    */
   auto operator=(ReadPageGuard &&that) noexcept -> ReadPageGuard &;
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Drop a ReadPageGuard
    *
    * ReadPageGuard's Drop should behave similarly to BasicPageGuard,
@@ -124,8 +128,7 @@ class ReadPageGuard {
    */
   void Drop();
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Destructor for ReadPageGuard
    *
    * Just like with BasicPageGuard, this should behave
@@ -142,9 +145,32 @@ class ReadPageGuard {
     return guard_.As<T>();
   }
 
+  /** @return the guarded page as a page type that is layered over Page, e.g. TablePage; nullptr for an empty guard */
+  template <class T>
+  auto AsPage() -> T * {
+    return static_cast<T *>(guard_.page_);
+  }
+
+  /** @return true if the guard reads without holding the read latch */
+  auto IsOptimistic() const -> bool { return is_optimistic_; }
+
+  /**
+   * @return true if the page has not been written since the guard was taken, i.e. everything read through it so far
+   * is consistent; always true for a latched guard
+   */
+  auto Validate() const -> bool { return !is_optimistic_ || guard_.page_->ValidateVersion(version_); }
+
+  /**
+   * Take the read latch of an optimistic guard, so that it reads like a regular guard from now on.
+   * @return true if the page has not been written since the guard was taken
+   */
+  auto Latch() -> bool;
+
  private:
-  // You may choose to get rid of this and add your own private variables.
   BasicPageGuard guard_;
+  bool is_optimistic_{false};
+  /** The version of the page when an optimistic guard was taken. */
+  uint64_t version_{0};
 };
 
 class WritePageGuard {
@@ -154,8 +180,7 @@ class WritePageGuard {
   WritePageGuard(const WritePageGuard &) = delete;
   auto operator=(const WritePageGuard &) -> WritePageGuard & = delete;
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Move constructor for WritePageGuard
    *
    * Very similar to BasicPageGuard. You want to create
@@ -164,8 +189,7 @@ class WritePageGuard {
    */
   WritePageGuard(WritePageGuard &&that) noexcept;
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Move assignment for WritePageGuard
    *
    * Very similar to BasicPageGuard. Given another WritePageGuard,
@@ -173,8 +197,7 @@ class WritePageGuard {
    */
   auto operator=(WritePageGuard &&that) noexcept -> WritePageGuard &;
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Drop a WritePageGuard
    *
    * WritePageGuard's Drop should behave similarly to BasicPageGuard,
@@ -184,8 +207,7 @@ class WritePageGuard {
    */
   void Drop();
 
-  /** TODO(P1): Add implementation
-   *
+  /**
    * @brief Destructor for WritePageGuard
    *
    * Just like with BasicPageGuard, this should behave
@@ -210,7 +232,6 @@ class WritePageGuard {
   }
 
  private:
-  // You may choose to get rid of this and add your own private variables.
   BasicPageGuard guard_;
 };
 
@@ -59,9 +59,24 @@ class TablePage : public Page {
   /** @return the page ID of the previous table page */
   auto GetPrevPageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_PREV_PAGE_ID); }
 
+  /** @return the number of free bytes; a tuple also needs GetTupleFootprint() - tuple.size_ of them for its slot */
+  auto GetFreeSpaceRemaining() -> uint32_t {
+    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
+  }
+
+  /** @return the number of free bytes a tuple needs to be inserted, including its slot */
+  static auto GetTupleFootprint(const Tuple &tuple) -> uint32_t { return tuple.GetLength() + SIZE_TUPLE; }
+
   /** @return the page ID of the next table page */
   auto GetNextPageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
 
+  /** @return the page ID of the next table page, read from the raw data of a table page (e.g. for read-ahead) */
+  static auto NextPageIdOf(const char *page_data) -> page_id_t {
+    page_id_t next_page_id;
+    memcpy(&next_page_id, page_data + OFFSET_NEXT_PAGE_ID, sizeof(page_id_t));
+    return next_page_id;
+  }
+
   /** Set the page id of the previous page in the table. */
   void SetPrevPageId(page_id_t prev_page_id) {
     memcpy(GetData() + OFFSET_PREV_PAGE_ID, &prev_page_id, sizeof(page_id_t));
@@ -84,6 +99,19 @@ class TablePage : public Page {
   auto InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager)
       -> bool;
 
+  /**
+   * Insert tuples in order, starting at tuples[first], until one does not fit.
+   * @param tuples tuples to insert
+   * @param first index of the first tuple to insert
+   * @param[out] rids the rid of every inserted tuple is appended here
+   * @param txn transaction performing the insert
+   * @param lock_manager the lock manager
+   * @param log_manager the log manager
+   * @return the number of tuples inserted
+   */
+  auto InsertTuples(const std::vector<Tuple> &tuples, size_t first, std::vector<RID> *rids, Transaction *txn,
+                    LockManager *lock_manager, LogManager *log_manager) -> size_t;
+
   /**
    * Mark a tuple as deleted. This does not actually delete the tuple.
    * @param rid rid of the tuple to mark as deleted
@@ -107,8 +135,11 @@ class TablePage : public Page {
   auto UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID &rid, Transaction *txn,
                    LockManager *lock_manager, LogManager *log_manager) -> bool;
 
-  /** To be called on commit or abort. Actually perform the delete or rollback an insert. */
-  void ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager);
+  /**
+   * To be called on commit or abort. Actually perform the delete or rollback an insert.
+   * @param[out] deleted_tuple if not nullptr, receives a copy of the removed tuple
+   */
+  void ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager, Tuple *deleted_tuple = nullptr);
 
   /** To be called on abort. Rollback a delete, i.e. this reverses a MarkDelete. */
   void RollbackDelete(const RID &rid, Transaction *txn, LogManager *log_manager);
@@ -123,6 +154,25 @@ class TablePage : public Page {
    */
   auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager) -> bool;
 
+  /**
+   * Drop the empty slots at the end of the slot array. Empty slots in between stay, since the rids of the tuples
+   * after them must not change. Tuple data needs no compaction: ApplyDelete closes the gap a tuple leaves behind.
+   * @return the number of bytes freed
+   */
+  auto Vacuum() -> uint32_t;
+
+  /** @return true if the page has no slots, which after Vacuum() means it holds no tuples, deleted or not */
+  auto IsEmpty() -> bool { return GetTupleCount() == 0; }
+
+  /**
+   * Point a tuple at the bytes of a tuple on this page without copying them. The tuple is valid only as long as the
+   * caller keeps this page pinned and latched.
+   * @param rid rid of the tuple to borrow
+   * @param[out] tuple the borrowed tuple
+   * @return true if the tuple exists
+   */
+  auto BorrowTuple(const RID &rid, Tuple *tuple) -> bool;
+
   /** @return the rid of the first tuple in this page */
 
   /**
@@ -167,10 +217,6 @@ class TablePage : public Page {
   /** Set the number of tuples in this page. */
   void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
 
-  auto GetFreeSpaceRemaining() -> uint32_t {
-    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
-  }
-
   /** @return tuple offset at slot slot_num */
   auto GetTupleOffsetAtSlot(uint32_t slot_num) -> uint32_t {
     return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num);
@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.h
+//
+// Identification: src/include/storage/table/free_space_map.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * FreeSpaceMap tracks roughly how many bytes are free on every page of a table heap, so that an insert goes straight
+ * to a page with room instead of walking the page chain.
+ *
+ * Free space is kept in NUM_CATEGORIES steps of `page_size / NUM_CATEGORIES` bytes, rounded down, so a page is only
+ * offered for a tuple that fit when the page was last updated. The categories are the leaves of a max segment tree
+ * over the pages in the order they were added, which finds a page with room in O(log n). Every search starts where
+ * the previous one ended, so concurrent inserters spread over all pages with room instead of piling onto the first.
+ *
+ * Since it tracks every page of the heap, the map also serves as the heap's list of pages, e.g. to split a scan.
+ *
+ * The map only lives in memory; TableHeap rebuilds it when a table is opened.
+ */
+class FreeSpaceMap {
+ public:
+  /** @param page_size the size of the pages being tracked */
+  explicit FreeSpaceMap(size_t page_size);
+
+  /**
+   * @brief Record the free bytes of a page, adding the page to the map if it is not tracked yet.
+   * @param page_id id of the page
+   * @param free_bytes the number of bytes free on the page
+   */
+  void Update(page_id_t page_id, size_t free_bytes);
+
+  /**
+   * @brief Find a page that had at least `bytes` free when it was last updated.
+   * @return the page id, or INVALID_PAGE_ID if no tracked page has room
+   */
+  auto Search(size_t bytes) -> page_id_t;
+
+  /**
+   * @brief Stop tracking a page, e.g. once it is released from the table heap.
+   * @param page_id id of the page
+   */
+  void Remove(page_id_t page_id);
+
+  /** @return true if the page is tracked */
+  auto Contains(page_id_t page_id) -> bool;
+
+  /** @return the ids of all tracked pages, in the order they were added */
+  auto GetPageIds() -> std::vector<page_id_t>;
+
+  /** @return the number of tracked pages */
+  auto GetNumPages() -> size_t;
+
+ private:
+  static constexpr size_t NUM_CATEGORIES = 256;
+  static constexpr size_t NOT_FOUND = SIZE_MAX;
+
+  /** @return the smallest leaf at or after `from` whose category is at least `category`, or NOT_FOUND */
+  auto FindFrom(size_t node, size_t lo, size_t hi, size_t from, uint8_t category) -> size_t;
+
+  /** @brief Double the number of leaves and rebuild the inner nodes. */
+  void Grow();
+
+  const size_t page_size_;
+  std::mutex latch_;
+  /** The page of every leaf; INVALID_PAGE_ID for the leaf of a removed page, whose category is 0. */
+  std::vector<page_id_t> page_ids_;
+  /** The leaf of every page. */
+  std::unordered_map<page_id_t, size_t> leaf_of_;
+  /** Number of leaves, a power of two; leaf i is node capacity_ + i, node 1 is the root. */
+  size_t capacity_{0};
+  /** Every node holds the largest category below it. */
+  std::vector<uint8_t> tree_;
+  /** The leaf the next search starts at. */
+  size_t next_leaf_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// overflow_store.h
+//
+// Identification: src/include/storage/table/overflow_store.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/** What a tuple stores in place of a varchar value that lives on overflow pages, after BUSTUB_VALUE_OVERFLOW. */
+struct OverflowPointer {
+  /** The first page of the chain holding the value. */
+  page_id_t first_page_id_;
+  /** The serialized length of the value, as it would have been stored in the tuple. */
+  uint32_t length_;
+};
+
+/**
+ * OverflowStore keeps varchar values that are too large for their tuple on chains of OverflowPages, so that a row only
+ * carries an OverflowPointer of a few bytes. A chain belongs to exactly one version of one tuple; TableHeap frees it
+ * at the first Vacuum after that version is gone for good.
+ *
+ * Overflow pages are not logged, like the pages of indexes.
+ */
+class OverflowStore {
+ public:
+  /**
+   * @param buffer_pool_manager the buffer pool manager the overflow pages are allocated from
+   * @param schema the schema of the tuples whose varchars are stored, nullptr if none are
+   */
+  OverflowStore(BufferPoolManager *buffer_pool_manager, const Schema *schema)
+      : buffer_pool_manager_(buffer_pool_manager), schema_(schema) {}
+
+  /** @return the schema of the tuples whose varchars are stored */
+  auto GetSchema() const -> const Schema * { return schema_; }
+
+  /**
+   * Copy a value to a new chain of overflow pages.
+   * @param data the value's data
+   * @param length the length of the data
+   * @param[out] pointer where the value was stored
+   * @return false if the pages could not be allocated, nothing is stored then
+   */
+  auto Write(const char *data, uint32_t length, OverflowPointer *pointer) -> bool;
+
+  /**
+   * Read a value back from its chain.
+   * @param pointer where the value is stored
+   * @return the varchar value
+   */
+  auto Read(const OverflowPointer &pointer) const -> Value;
+
+  /**
+   * Release the pages of a chain to the buffer pool.
+   * @param first_page_id the first page of the chain
+   */
+  void Free(page_id_t first_page_id);
+
+ private:
+  BufferPoolManager *buffer_pool_manager_;
+  const Schema *schema_;
+};
+
+}  // namespace bustub
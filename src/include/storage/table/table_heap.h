@@ -12,20 +12,50 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <shared_mutex>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
+#include "storage/table/free_space_map.h"
+#include "storage/table/overflow_store.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
+/** What a TableHeap::Vacuum reclaimed. */
+struct VacuumStats {
+  /** Pages visited. */
+  size_t pages_{0};
+  /** Empty pages released to the buffer pool. */
+  size_t released_pages_{0};
+  /** Bytes freed, counting released pages in full. */
+  size_t reclaimed_bytes_{0};
+  /** Overflow chains of gone row versions released to the buffer pool. */
+  size_t released_overflow_chains_{0};
+};
+
 /**
  * TableHeap represents a physical table on disk.
  * This is just a doubly-linked list of pages.
+ *
+ * Inserts find a page with room through a FreeSpaceMap and only extend the list at its end when no page has room.
+ *
+ * If the heap knows the schema of its tuples, varchars longer than page_size / OVERFLOW_THRESHOLD_RATIO are moved to
+ * an OverflowStore on the way in, largest first and more of them if the row still does not fit a page. Views of tuples
+ * fetch such a value only when its column is asked for, and so do copies, which keep the OverflowPointer. The chain
+ * of a row version that is gone is therefore not freed right away but retired, and the next Vacuum frees it: a copy
+ * of a tuple stays readable until then.
  */
 class TableHeap {
   friend class TableIterator;
+  friend class TableViewIterator;
 
  public:
   ~TableHeap() = default;
@@ -36,9 +66,11 @@ class TableHeap {
    * @param lock_manager the lock manager
    * @param log_manager the log manager
    * @param first_page_id the id of the first page
+   * @param schema the schema of the tuples, needed to move large varchars to overflow pages; without it tuples are
+   * stored as they are
    */
   TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-            page_id_t first_page_id);
+            page_id_t first_page_id, const Schema *schema = nullptr);
 
   /**
    * Create a table heap with a transaction. (create table)
@@ -46,12 +78,15 @@ class TableHeap {
    * @param lock_manager the lock manager
    * @param log_manager the log manager
    * @param txn the creating transaction
+   * @param schema the schema of the tuples, needed to move large varchars to overflow pages; without it tuples are
+   * stored as they are
    */
   TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-            Transaction *txn);
+            Transaction *txn, const Schema *schema = nullptr);
 
   /**
-   * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
+   * Insert a tuple into a page that the free space map says has room, or into a new page at the end of the table. If
+   * the tuple is too large (>= page_size) even with its large varchars on overflow pages, return false.
    * @param tuple tuple to insert
    * @param[out] rid the rid of the inserted tuple
    * @param txn the transaction performing the insert
@@ -59,6 +94,16 @@ class TableHeap {
    */
   auto InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool;
 
+  /**
+   * Insert tuples in order, filling every page with as many of them as fit while it is latched once. If a tuple is
+   * too large (>= page_size), nothing is inserted and false is returned.
+   * @param tuples tuples to insert
+   * @param[out] rids the rid of every inserted tuple is appended here, in the order of the tuples
+   * @param txn the transaction performing the insert
+   * @return true iff all tuples were inserted
+   */
+  auto InsertTuples(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn) -> bool;
+
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
    * @param rid resource id of the tuple of delete
@@ -83,6 +128,22 @@ class TableHeap {
    */
   void ApplyDelete(const RID &rid, Transaction *txn);
 
+  /**
+   * Called on Commit to drop the old version of an updated tuple, which retires its overflow pages.
+   * @param old_tuple the old version, as saved in the write set
+   * @param txn transaction performing the update
+   */
+  void ApplyUpdate(const Tuple &old_tuple, Transaction *txn);
+
+  /**
+   * Called on abort to rollback an update: put back the old version as it was stored, and retire the overflow pages
+   * of the version it replaces.
+   * @param old_tuple the old version, as saved in the write set
+   * @param rid rid of the updated tuple
+   * @param txn transaction performing the rollback
+   */
+  void RollbackUpdate(const Tuple &old_tuple, const RID &rid, Transaction *txn);
+
   /**
    * Called on abort to rollback a delete.
    * @param rid rid of the deleted tuple.
@@ -99,20 +160,118 @@ class TableHeap {
    */
   auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock = true) -> bool;
 
+  /**
+   * Read a tuple from the table without copying it.
+   * @param rid rid of the tuple to read
+   * @param[out] view a view of the tuple, which keeps its page pinned and read-latched
+   * @return true if the read was successful (i.e. the tuple exists)
+   */
+  auto GetTupleView(const RID &rid, TupleView *view) -> bool;
+
   /** @return the begin iterator of this table */
   auto Begin(Transaction *txn) -> TableIterator;
 
   /** @return the end iterator of this table */
   auto End() -> TableIterator;
 
+  /** @return the begin iterator of a scan of this table that yields views instead of copies */
+  auto ViewBegin() -> TableViewIterator;
+
+  /** @return the end iterator of a view scan */
+  auto ViewEnd() -> TableViewIterator;
+
+  /**
+   * Read every tuple of the table with several threads, each of which reads its own range of the pages the free space
+   * map lists. Pages appended during the scan may be missed, pages Vacuum releases during the scan are skipped.
+   * @param num_threads the number of threads to read with; at most GetScanThreads(num_threads), and at most one per
+   * page, is used
+   * @param visit called with the number of the reading thread and a copy of a tuple, after its page is released; the
+   * tuple is only valid during the call
+   */
+  void ParallelScan(size_t num_threads, const std::function<void(size_t, const Tuple &)> &visit);
+
+  /**
+   * @return how many of num_threads a ParallelScan runs with at most: one per four frames of the buffer pool, and no
+   * more than the read-ahead window if read-ahead is enabled
+   */
+  auto GetScanThreads(size_t num_threads) -> size_t;
+
   /** @return the id of the first page of this table */
   inline auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
 
+  /**
+   * Reclaim the space of deleted tuples: drop the trailing empty slots of every page, refresh the free space map, and
+   * release empty pages and the overflow chains retired before this call back to the buffer pool. Concurrent readers
+   * and writers may keep using the table.
+   * @return what was reclaimed
+   */
+  auto Vacuum() -> VacuumStats;
+
  private:
+  /** Most pages appended at once, when that many inserters are waiting to extend the table. */
+  static constexpr size_t MAX_EXTEND_PAGES = 8;
+
+  /**
+   * Append new pages to the table, one for this inserter and one for every inserter waiting behind it, so that they
+   * all insert into different pages afterwards.
+   * @param footprint the bytes the tuple to insert needs
+   * @param txn the transaction performing the insert
+   * @param min_pages the number of pages to append at least, for an inserter with a batch of tuples
+   * @return a page with room for the tuple, INVALID_PAGE_ID if no page could be created
+   */
+  auto ExtendHeap(size_t footprint, Transaction *txn, size_t min_pages = 1) -> page_id_t;
+
+  /** @return the rid of the first tuple in the table, or an invalid rid if the table is empty */
+  auto FirstTupleRid() -> RID;
+
+  /**
+   * Pin a page that the free space map says has room for footprint bytes, or one appended to the table for them.
+   * @param footprint the bytes the tuple to insert needs
+   * @param txn the transaction performing the insert
+   * @param min_pages the number of pages to append at least, if the table has to grow
+   * @return the pinned page, nullptr if no page could be found or created
+   */
+  auto FetchPageWithRoom(size_t footprint, Transaction *txn, size_t min_pages = 1) -> TablePage *;
+
+  /**
+   * Prepare a tuple for storage: move its longest varchars to overflow pages until the remaining ones are at most the
+   * overflow threshold and the tuple fits a page. Varchars the tuple already has on overflow pages are copied to new
+   * ones, since every chain belongs to one stored tuple.
+   * @param tuple the tuple to store
+   * @param[out] spilled the tuple with overflow pointers, if anything had to be moved
+   * @return tuple or spilled, whichever is to be stored; nullptr if the tuple cannot be stored
+   */
+  auto SpillLargeValues(const Tuple &tuple, Tuple *spilled) -> const Tuple *;
+
+  /** Free the overflow pages of a tuple that was never visible to readers. */
+  void FreeOverflow(const Tuple &tuple);
+
+  /** Hand the overflow pages of a row version that is gone to the next Vacuum, copies may still read them. */
+  void RetireOverflow(const Tuple &tuple);
+
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
+  /** The schema of the tuples, or nullptr if large varchars are not moved out of the tuples. */
+  std::unique_ptr<const Schema> schema_;
+  OverflowStore overflow_store_;
   page_id_t first_page_id_{};
+  /** The page at the end of the list; guarded by extend_latch_. */
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+  /** Serializes appending pages. */
+  std::mutex extend_latch_;
+  /** Number of inserters waiting for extend_latch_. */
+  std::atomic<size_t> extend_waiters_{0};
+  /** Free bytes of every page of the table. */
+  FreeSpaceMap free_space_map_;
+  /**
+   * Held shared from a page lookup (in the free space map or its list of pages) until the page is pinned, and
+   * exclusively by Vacuum to release a page.
+   */
+  std::shared_mutex vacuum_latch_;
+  /** First pages of the overflow chains the next Vacuum frees; guarded by retired_overflow_latch_. */
+  std::vector<page_id_t> retired_overflow_;
+  std::mutex retired_overflow_latch_;
 };
 
 }  // namespace bustub
@@ -13,17 +13,21 @@
 #pragma once
 
 #include <cassert>
+#include <memory>
 
 #include "common/rid.h"
 #include "concurrency/transaction.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_view.h"
 
 namespace bustub {
 
 class TableHeap;
+class TablePage;
 
 /**
- * TableIterator enables the sequential scan of a TableHeap.
+ * TableIterator enables the sequential scan of a TableHeap. It copies out the current tuple, and keeps the page of
+ * that tuple pinned (but not latched), so that a vacuum does not release the page under it.
  */
 class TableIterator {
   friend class Cursor;
@@ -31,10 +35,9 @@ class TableIterator {
  public:
   TableIterator(TableHeap *table_heap, RID rid, Transaction *txn);
 
-  TableIterator(const TableIterator &other)
-      : table_heap_(other.table_heap_), tuple_(new Tuple(*other.tuple_)), txn_(other.txn_) {}
+  TableIterator(const TableIterator &other);
 
-  ~TableIterator() { delete tuple_; }
+  ~TableIterator();
 
   inline auto operator==(const TableIterator &itr) const -> bool {
     return tuple_->GetRid().Get() == itr.tuple_->GetRid().Get();
@@ -50,17 +53,52 @@ class TableIterator {
 
   auto operator++(int) -> TableIterator;
 
-  auto operator=(const TableIterator &other) -> TableIterator & {
-    table_heap_ = other.table_heap_;
-    *tuple_ = *other.tuple_;
-    txn_ = other.txn_;
-    return *this;
-  }
+  auto operator=(const TableIterator &other) -> TableIterator &;
 
  private:
+  /** @return the page with the given id, pinned for this iterator; nullptr for INVALID_PAGE_ID */
+  auto PinPage(page_id_t page_id) const -> TablePage *;
+
+  /** Drop the pin on page_. */
+  void UnpinPage();
+
   TableHeap *table_heap_;
   Tuple *tuple_;
   Transaction *txn_;
+  /** The page of the current tuple, pinned; nullptr at the end. */
+  TablePage *page_{nullptr};
+};
+
+/**
+ * TableViewIterator scans a TableHeap without copying tuples: it yields TupleViews into the page it is on, and keeps
+ * that page pinned and read-latched until it moves on to the next one. See TupleView for what a reader must not do
+ * while it holds a view.
+ */
+class TableViewIterator {
+ public:
+  TableViewIterator(TableHeap *table_heap, RID rid);
+
+  inline auto operator==(const TableViewIterator &itr) const -> bool {
+    return view_.GetRid().Get() == itr.view_.GetRid().Get();
+  }
+
+  inline auto operator!=(const TableViewIterator &itr) const -> bool { return !(*this == itr); }
+
+  auto operator*() -> const TupleView &;
+
+  auto operator->() -> const TupleView *;
+
+  auto operator++() -> TableViewIterator &;
+
+ private:
+  /** Point view_ at the tuple with the given rid on page_, or at nothing if the rid is invalid. */
+  void Borrow(const RID &rid);
+
+  TableHeap *table_heap_;
+  /** The page the iterator is on, and the guard that keeps it latched; both null at the end. */
+  TablePage *page_{nullptr};
+  std::shared_ptr<ReadPageGuard> page_guard_;
+  TupleView view_;
 };
 
 }  // namespace bustub
@@ -17,20 +17,30 @@
 
 #include "catalog/schema.h"
 #include "common/rid.h"
+#include "type/abstract_pool.h"
 #include "type/value.h"
 
 namespace bustub {
 
+class OverflowStore;
+struct OverflowPointer;
+
 /**
  * Tuple format:
  * ---------------------------------------------------------------------
  * | FIXED-SIZE or VARIED-SIZED OFFSET | PAYLOAD OF VARIED-SIZED FIELD |
  * ---------------------------------------------------------------------
+ *
+ * A varchar of a table heap tuple may live on overflow pages, with an OverflowPointer in its payload. A tuple borrowed
+ * from a page or copied out of it reads it from there only when the column is asked for; TableHeap keeps the overflow
+ * pages of a row version that is gone until its next Vacuum, so that copies can keep the pointer.
  */
 class Tuple {
   friend class TablePage;
   friend class TableHeap;
   friend class TableIterator;
+  friend class TupleView;
+  friend class TableViewIterator;
 
  public:
   // Default constructor (to create a dummy tuple)
@@ -39,13 +49,17 @@ class Tuple {
   // constructor for table heap tuple
   explicit Tuple(RID rid) : rid_(rid) {}
 
-  // constructor for creating a new tuple based on input value
-  Tuple(std::vector<Value> values, const Schema *schema);
+  // constructor for creating a new tuple based on input value; with a pool, the tuple data is allocated from the pool
+  // and lives as long as the pool, and copies of the tuple share it
+  Tuple(std::vector<Value> values, const Schema *schema, AbstractPool *pool = nullptr);
+
+  // constructor for a tuple borrowing the bytes of a page, it is only valid while the page is pinned and latched
+  Tuple(RID rid, const char *data, uint32_t size) : rid_(rid), size_(size), data_(const_cast<char *>(data)) {}
 
   // copy constructor, deep copy
   Tuple(const Tuple &other);
 
-  // assign operator, deep copy
+  // assign operator, deep copy; reuses this tuple's buffer if it is large enough
   auto operator=(const Tuple &other) -> Tuple &;
 
   ~Tuple() {
@@ -75,14 +89,15 @@ class Tuple {
   auto GetValue(const Schema *schema, uint32_t column_idx) const -> Value;
 
   // Generates a key tuple given schemas and attributes
-  auto KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) -> Tuple;
+  auto KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) const
+      -> Tuple;
 
   // Is the column value null ?
   inline auto IsNull(const Schema *schema, uint32_t column_idx) const -> bool {
     Value value = GetValue(schema, column_idx);
     return value.IsNull();
   }
-  inline auto IsAllocated() -> bool { return allocated_; }
+  inline auto IsAllocated() const -> bool { return allocated_; }
 
   auto ToString(const Schema *schema) const -> std::string;
 
@@ -90,10 +105,18 @@ class Tuple {
   // Get the starting storage address of specific column
   auto GetDataPtr(const Schema *schema, uint32_t column_idx) const -> const char *;
 
+  // Is the varchar of the column on overflow pages? If so, pointer is set to where
+  auto GetOverflowPointer(const Schema *schema, uint32_t column_idx, OverflowPointer *pointer) const -> bool;
+
+  // Deep copy size bytes into this tuple, reusing its buffer if it is large enough
+  void CopyData(const char *data, uint32_t size);
+
   bool allocated_{false};  // is allocated?
   RID rid_{};              // if pointing to the table heap, the rid is valid
   uint32_t size_{0};
+  uint32_t capacity_{0};  // bytes allocated for data_, may exceed size_ when the buffer is reused
   char *data_{nullptr};
+  const OverflowStore *overflow_store_{nullptr};  // where varchars on overflow pages are read from, set by TableHeap
 };
 
 }  // namespace bustub
@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_view.h
+//
+// Identification: src/include/storage/table/tuple_view.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+
+#include "storage/page/page_guard.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TupleView is a tuple borrowed from a table page. It reads the columns straight from the page, which it keeps pinned
+ * and read-latched through a guard shared with every other view of the same page. Materialize() the tuple if it has
+ * to outlive the view.
+ *
+ * Since the page stays latched, a thread must release its views of a page before it writes to that page, e.g. by
+ * deleting or updating a viewed tuple, or it deadlocks on the latch.
+ */
+class TupleView {
+ public:
+  /** Create an empty view that points to no tuple. */
+  TupleView() = default;
+
+  TupleView(std::shared_ptr<ReadPageGuard> guard, const Tuple &tuple) : guard_(std::move(guard)), tuple_(tuple) {}
+
+  /** @return true if the view points to a tuple */
+  inline auto IsValid() const -> bool { return guard_ != nullptr; }
+
+  /** @return the borrowed tuple, valid only as long as this view */
+  inline auto operator*() const -> const Tuple & { return tuple_; }
+
+  inline auto operator->() const -> const Tuple * { return &tuple_; }
+
+  inline auto GetRid() const -> RID { return tuple_.GetRid(); }
+
+  inline auto GetValue(const Schema *schema, uint32_t column_idx) const -> Value {
+    return tuple_.GetValue(schema, column_idx);
+  }
+
+  /** @return a copy of the tuple that owns its data */
+  auto Materialize() const -> Tuple;
+
+  /** Stop pointing to the tuple; the page is released once no other view of it is left. */
+  void Release();
+
+ private:
+  std::shared_ptr<ReadPageGuard> guard_;
+  Tuple tuple_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena_pool.h
+//
+// Identification: src/include/type/arena_pool.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "common/macros.h"
+#include "type/abstract_pool.h"
+
+namespace bustub {
+
+/**
+ * ArenaPool is a bump allocator for memory that lives as long as a query. Allocations are carved out of large blocks,
+ * Free() does nothing, and all memory is returned at once by Reset() or when the pool is destroyed. It is not
+ * thread-safe; every query owns its own pool.
+ */
+class ArenaPool : public AbstractPool {
+ public:
+  /** Size of the first block; every further block doubles, up to MAX_BLOCK_SIZE. */
+  static constexpr size_t MIN_BLOCK_SIZE = 4096;
+  static constexpr size_t MAX_BLOCK_SIZE = 1 << 20;
+
+  ArenaPool() = default;
+
+  ~ArenaPool() override = default;
+
+  DISALLOW_COPY_AND_MOVE(ArenaPool);
+
+  /**
+   * @brief Allocate size bytes, aligned for any type.
+   * @return a pointer valid until the pool is reset or destroyed
+   */
+  auto Allocate(size_t size) -> void * override;
+
+  /** @brief Does nothing, the memory is returned with the rest of the pool. */
+  void Free(void *ptr) override {}
+
+  /** @brief Return all allocations at once. The current block is kept for reuse. */
+  void Reset();
+
+  /** @return the bytes handed out since the last reset */
+  auto GetBytesAllocated() const -> size_t { return bytes_allocated_; }
+
+  /** @return the bytes of all blocks the pool holds */
+  auto GetBytesReserved() const -> size_t { return bytes_reserved_; }
+
+ private:
+  /** Allocate a block of at least size bytes and make it the current one, unless it is a dedicated one. */
+  auto AllocateBlock(size_t size) -> char *;
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  /** The block that small allocations are carved from, and its size; free bytes start at cur_. */
+  size_t cur_block_{0};
+  size_t cur_block_size_{0};
+  char *cur_{nullptr};
+  size_t remaining_{0};
+  size_t next_block_size_{MIN_BLOCK_SIZE};
+  size_t bytes_allocated_{0};
+  size_t bytes_reserved_{0};
+};
+
+/**
+ * ArenaAllocator lets standard containers, like the hash tables of aggregations and joins, allocate their nodes from
+ * an ArenaPool. Without a pool it falls back to the global allocator. Memory given back by the container, e.g. the old
+ * bucket array after a rehash, is only reclaimed with the pool.
+ */
+template <class T>
+class ArenaAllocator {
+ public:
+  using value_type = T;  // NOLINT
+
+  explicit ArenaAllocator(ArenaPool *pool = nullptr) : pool_(pool) {}
+
+  template <class U>
+  ArenaAllocator(const ArenaAllocator<U> &other) : pool_(other.GetPool()) {}  // NOLINT
+
+  auto allocate(size_t n) -> T * {  // NOLINT
+    if (pool_ == nullptr) {
+      return std::allocator<T>().allocate(n);
+    }
+    return static_cast<T *>(pool_->Allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T *ptr, size_t n) {  // NOLINT
+    if (pool_ == nullptr) {
+      std::allocator<T>().deallocate(ptr, n);
+    }
+  }
+
+  auto GetPool() const -> ArenaPool * { return pool_; }
+
+  template <class U>
+  auto operator==(const ArenaAllocator<U> &other) const -> bool {
+    return pool_ == other.GetPool();
+  }
+
+  template <class U>
+  auto operator!=(const ArenaAllocator<U> &other) const -> bool {
+    return pool_ != other.GetPool();
+  }
+
+ private:
+  ArenaPool *pool_;
+};
+
+}  // namespace bustub
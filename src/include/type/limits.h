@@ -42,6 +42,8 @@ static constexpr uint64_t BUSTUB_DATE_MAX = INT_MAX;
 static constexpr int8_t BUSTUB_BOOLEAN_MAX = 1;
 
 static constexpr uint32_t BUSTUB_VALUE_NULL = UINT_MAX;
+// Length of a varchar stored on overflow pages; an OverflowPointer follows it instead of the data.
+static constexpr uint32_t BUSTUB_VALUE_OVERFLOW = UINT_MAX - 1;
 static constexpr int8_t BUSTUB_INT8_NULL = SCHAR_MIN;
 static constexpr int16_t BUSTUB_INT16_NULL = SHRT_MIN;
 static constexpr int32_t BUSTUB_INT32_NULL = INT_MIN;
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cstring>
 #include <stdexcept>
 #include <string>
 
@@ -34,7 +35,11 @@ namespace bustub {
 
 class ValueFactory {
  public:
-  static inline auto Clone(const Value &src, __attribute__((__unused__)) AbstractPool *dataPool = nullptr) -> Value {
+  /** Copy a value. With a pool, the bytes of a varchar are copied into the pool, and the copy does not own them. */
+  static inline auto Clone(const Value &src, AbstractPool *dataPool = nullptr) -> Value {
+    if (dataPool != nullptr && src.GetTypeId() == TypeId::VARCHAR && !src.IsNull()) {
+      return GetVarcharValue(src.GetData(), src.GetLength(), true, dataPool);
+    }
     return src.Copy();
   }
 
@@ -58,19 +63,29 @@ class ValueFactory {
 
   static inline auto GetBooleanValue(int8_t value) -> Value { return {TypeId::BOOLEAN, value}; }
 
-  static inline auto GetVarcharValue(const char *value, bool manage_data,
-                                     __attribute__((__unused__)) AbstractPool *pool = nullptr) -> Value {
+  static inline auto GetVarcharValue(const char *value, bool manage_data, AbstractPool *pool = nullptr) -> Value {
     auto len = static_cast<uint32_t>(value == nullptr ? 0U : strlen(value) + 1);
-    return GetVarcharValue(value, len, manage_data);
+    return GetVarcharValue(value, len, manage_data, pool);
   }
 
-  static inline auto GetVarcharValue(const char *value, uint32_t len, bool manage_data,
-                                     __attribute__((__unused__)) AbstractPool *pool = nullptr) -> Value {
+  /**
+   * With a pool, a varchar that should manage its data gets a copy allocated from the pool instead, which lives as
+   * long as the pool and is not freed by the value.
+   */
+  static inline auto GetVarcharValue(const char *value, uint32_t len, bool manage_data, AbstractPool *pool = nullptr)
+      -> Value {
+    if (pool != nullptr && manage_data && value != nullptr) {
+      auto *data = static_cast<char *>(pool->Allocate(len));
+      memcpy(data, value, len);
+      return {TypeId::VARCHAR, data, len, false};
+    }
     return {TypeId::VARCHAR, value, len, manage_data};
   }
 
-  static inline auto GetVarcharValue(const std::string &value, __attribute__((__unused__)) AbstractPool *pool = nullptr)
-      -> Value {
+  static inline auto GetVarcharValue(const std::string &value, AbstractPool *pool = nullptr) -> Value {
+    if (pool != nullptr) {
+      return GetVarcharValue(value.c_str(), static_cast<uint32_t>(value.length()) + 1, true, pool);
+    }
     return {TypeId::VARCHAR, value};
   }
 
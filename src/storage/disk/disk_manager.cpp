@@ -10,13 +10,24 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <memory>
 #include <mutex>  // NOLINT
 #include <string>
 #include <thread>  // NOLINT
+#include <utility>
+#include <vector>
 
 #include "common/exception.h"
 #include "common/logger.h"
@@ -26,11 +37,24 @@ namespace bustub {
 
 static char *buffer_used;
 
+/** Throw unless the page size is a power of two between BUSTUB_PAGE_SIZE and BUSTUB_MAX_PAGE_SIZE. */
+static auto CheckPageSize(size_t page_size) -> size_t {
+  if (page_size < BUSTUB_PAGE_SIZE || page_size > BUSTUB_MAX_PAGE_SIZE || (page_size & (page_size - 1)) != 0) {
+    throw Exception(ExceptionType::OUT_OF_RANGE,
+                    "page size must be a power of two between " + std::to_string(BUSTUB_PAGE_SIZE) + " and " +
+                        std::to_string(BUSTUB_MAX_PAGE_SIZE));
+  }
+  return page_size;
+}
+
+DiskManager::DiskManager(size_t page_size) : page_size_(CheckPageSize(page_size)) {}
+
 /**
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
  */
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+DiskManager::DiskManager(const std::string &db_file, bool direct_io, size_t page_size)
+    : page_size_(CheckPageSize(page_size)), file_name_(db_file) {
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
@@ -49,27 +73,80 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
     }
   }
 
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
-    if (!db_io_.is_open()) {
-      throw Exception("can't open db file");
+  // create the file if it does not exist
+  if (direct_io) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT | O_DIRECT, 0644);
+    if (db_fd_ < 0 && errno == EINVAL) {
+      LOG_WARN("O_DIRECT is not supported for %s, falling back to buffered I/O", db_file.c_str());
     }
+    direct_io_ = db_fd_ >= 0;
+  }
+  if (db_fd_ < 0) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+  }
+  if (db_fd_ < 0) {
+    throw Exception("can't open db file");
+  }
+
+  std::string fpm_name = file_name_.substr(0, n) + ".fpm";
+  fpm_fd_ = open(fpm_name.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fpm_fd_ < 0) {
+    throw Exception("can't open free page map file");
   }
+  // A map left over next to an empty db file belongs to an earlier database of the same name.
+  if (GetFileSize(db_file) <= 0 && ftruncate(fpm_fd_, 0) < 0) {
+    throw Exception("can't reset free page map file");
+  }
+  auto fpm_size = static_cast<size_t>(std::max(GetFileSize(fpm_name), 0));
+  uint64_t file_page_size = page_size_;
+  if (fpm_size < FPM_HEADER_SIZE) {
+    // A new database, or one from before the page size was recorded; from now on it is.
+    if (pwrite(fpm_fd_, &file_page_size, sizeof(file_page_size), 0) != sizeof(file_page_size) || fsync(fpm_fd_) < 0) {
+      throw Exception("can't write free page map file");
+    }
+    fpm_size = FPM_HEADER_SIZE;
+  } else if (pread(fpm_fd_, &file_page_size, sizeof(file_page_size), 0) != sizeof(file_page_size)) {
+    throw Exception("can't read free page map file");
+  }
+  if (file_page_size != page_size_) {
+    close(db_fd_);
+    close(fpm_fd_);
+    db_fd_ = fpm_fd_ = -1;
+    throw Exception(db_file + " was created with a page size of " + std::to_string(file_page_size) + ", not " +
+                    std::to_string(page_size_));
+  }
+  std::vector<uint64_t> words((fpm_size - FPM_HEADER_SIZE) / sizeof(uint64_t));
+  if (!words.empty() && pread(fpm_fd_, words.data(), words.size() * sizeof(uint64_t), FPM_HEADER_SIZE) < 0) {
+    throw Exception("can't read free page map file");
+  }
+  free_pages_.Load(std::move(words));
+  auto db_pages = (static_cast<size_t>(std::max(GetFileSize(db_file), 0)) + page_size_ - 1) / page_size_;
+  num_pages_ = std::max(static_cast<page_id_t>(db_pages), free_pages_.GetEnd());
   buffer_used = nullptr;
 }
 
+DiskManager::~DiskManager() {
+  SyncFreePageMap();
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+  }
+  if (fpm_fd_ >= 0) {
+    close(fpm_fd_);
+  }
+}
+
 /**
  * Close all file streams
  */
 void DiskManager::ShutDown() {
-  {
-    std::scoped_lock scoped_db_io_latch(db_io_latch_);
-    db_io_.close();
+  SyncFreePageMap();
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+    db_fd_ = -1;
+  }
+  if (fpm_fd_ >= 0) {
+    close(fpm_fd_);
+    fpm_fd_ = -1;
   }
   log_io_.close();
 }
@@ -78,47 +155,170 @@ void DiskManager::ShutDown() {
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  size_t offset = static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE;
-  // set write cursor to offset
   num_writes_ += 1;
-  db_io_.seekp(offset);
-  db_io_.write(page_data, BUSTUB_PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
-    LOG_DEBUG("I/O error while writing");
+  if (direct_io_ && reinterpret_cast<uintptr_t>(page_data) % BUSTUB_PAGE_ALIGNMENT != 0) {
+    std::unique_ptr<char, decltype(&std::free)> buffer(
+        static_cast<char *>(std::aligned_alloc(BUSTUB_PAGE_ALIGNMENT, page_size_)), &std::free);
+    memcpy(buffer.get(), page_data, page_size_);
+    WritePageAt(page_id, buffer.get());
     return;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
+  WritePageAt(page_id, page_data);
+}
+
+/**
+ * Write the contents of consecutive pages into disk file, one pwritev per IOV_MAX pages
+ */
+void DiskManager::WritePages(page_id_t page_id, const std::vector<const char *> &pages) {
+  if (direct_io_ && std::any_of(pages.begin(), pages.end(), [](const char *data) {
+        return reinterpret_cast<uintptr_t>(data) % BUSTUB_PAGE_ALIGNMENT != 0;
+      })) {
+    for (size_t i = 0; i < pages.size(); ++i) {
+      WritePage(page_id + static_cast<page_id_t>(i), pages[i]);
+    }
+    return;
+  }
+
+  num_writes_ += static_cast<int>(pages.size());
+  for (size_t first = 0; first < pages.size(); first += IOV_MAX) {
+    std::vector<iovec> iov(std::min<size_t>(IOV_MAX, pages.size() - first));
+    for (size_t i = 0; i < iov.size(); ++i) {
+      iov[i].iov_base = const_cast<char *>(pages[first + i]);  // NOLINT
+      iov[i].iov_len = page_size_;
+    }
+    auto offset = (static_cast<off_t>(page_id) + static_cast<off_t>(first)) * page_size_;
+    size_t next = 0;
+    while (next < iov.size()) {
+      ssize_t rc = pwritev(db_fd_, iov.data() + next, static_cast<int>(iov.size() - next), offset);
+      // check for I/O error
+      if (rc < 0) {
+        LOG_DEBUG("I/O error while writing");
+        return;
+      }
+      offset += rc;
+      // skip over what was written, the kernel may stop in the middle of a page
+      for (; next < iov.size() && static_cast<size_t>(rc) >= iov[next].iov_len; ++next) {
+        rc -= static_cast<ssize_t>(iov[next].iov_len);
+      }
+      if (next < iov.size()) {
+        iov[next].iov_base = static_cast<char *>(iov[next].iov_base) + rc;
+        iov[next].iov_len -= rc;
+      }
+    }
+  }
 }
 
 /**
  * Read the contents of the specified page into the given memory area
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  int offset = page_id * BUSTUB_PAGE_SIZE;
-  // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
-    LOG_DEBUG("I/O error reading past end of file");
-    // std::cerr << "I/O error while reading" << std::endl;
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, BUSTUB_PAGE_SIZE);
-    if (db_io_.bad()) {
+  if (direct_io_ && reinterpret_cast<uintptr_t>(page_data) % BUSTUB_PAGE_ALIGNMENT != 0) {
+    std::unique_ptr<char, decltype(&std::free)> buffer(
+        static_cast<char *>(std::aligned_alloc(BUSTUB_PAGE_ALIGNMENT, page_size_)), &std::free);
+    ReadPageAt(page_id, buffer.get());
+    memcpy(page_data, buffer.get(), page_size_);
+    return;
+  }
+  ReadPageAt(page_id, page_data);
+}
+
+/**
+ * Private helper function to write one page at its offset in the db file
+ */
+void DiskManager::WritePageAt(page_id_t page_id, const char *page_data) {
+  auto offset = static_cast<off_t>(page_id) * page_size_;
+  size_t written = 0;
+  while (written < page_size_) {
+    ssize_t rc = pwrite(db_fd_, page_data + written, page_size_ - written, offset + written);
+    // check for I/O error
+    if (rc < 0) {
+      LOG_DEBUG("I/O error while writing");
+      return;
+    }
+    written += rc;
+  }
+}
+
+/**
+ * Private helper function to read one page from its offset in the db file
+ */
+void DiskManager::ReadPageAt(page_id_t page_id, char *page_data) {
+  auto offset = static_cast<off_t>(page_id) * page_size_;
+  size_t read_count = 0;
+  while (read_count < page_size_) {
+    ssize_t rc = pread(db_fd_, page_data + read_count, page_size_ - read_count, offset + read_count);
+    if (rc < 0) {
       LOG_DEBUG("I/O error while reading");
       return;
     }
-    // if file ends before reading BUSTUB_PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < BUSTUB_PAGE_SIZE) {
-      LOG_DEBUG("Read less than a page");
-      db_io_.clear();
-      // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
+    if (rc == 0) {
+      break;
     }
+    read_count += rc;
+  }
+  // if file ends before reading page_size_
+  if (read_count < page_size_) {
+    LOG_DEBUG("Read less than a page");
+    memset(page_data + read_count, 0, page_size_ - read_count);
+  }
+}
+
+/**
+ * Take the lowest deallocated page id of a stripe, the change reaches the .fpm file with the next SyncFreePageMap
+ */
+auto DiskManager::AllocateFreePage(uint32_t num_stripes, uint32_t stripe) -> page_id_t {
+  std::scoped_lock lock(free_pages_latch_);
+  auto page_id = free_pages_.Take(num_stripes, stripe);
+  if (page_id != INVALID_PAGE_ID) {
+    dirty_words_.insert(FreePageMap::WordOf(page_id));
+  }
+  return page_id;
+}
+
+/**
+ * Record a deallocated page in the free-page map
+ */
+void DiskManager::DeallocatePage(page_id_t page_id) {
+  std::scoped_lock lock(free_pages_latch_);
+  if (page_id < 0 || free_pages_.IsFree(page_id)) {
+    return;
+  }
+  free_pages_.Free(page_id);
+  dirty_words_.insert(FreePageMap::WordOf(page_id));
+}
+
+auto DiskManager::GetNumFreePages() -> size_t {
+  std::scoped_lock lock(free_pages_latch_);
+  return free_pages_.GetNumFree();
+}
+
+/**
+ * Write the words of the free-page map changed since the last sync to the .fpm file, then sync it once
+ */
+void DiskManager::SyncFreePageMap() {
+  // Serializes the writers, so an older snapshot of a word never lands after a newer one.
+  std::scoped_lock sync_lock(fpm_sync_latch_);
+  std::vector<std::pair<size_t, uint64_t>> words;
+  {
+    std::scoped_lock lock(free_pages_latch_);
+    words.reserve(dirty_words_.size());
+    for (auto word : dirty_words_) {
+      words.emplace_back(word, free_pages_.GetWords()[word]);
+    }
+    dirty_words_.clear();
+  }
+  if (fpm_fd_ < 0 || words.empty()) {
+    return;
+  }
+  for (const auto &[word, value] : words) {
+    auto offset = static_cast<off_t>(FPM_HEADER_SIZE + word * sizeof(uint64_t));
+    if (pwrite(fpm_fd_, &value, sizeof(uint64_t), offset) != sizeof(uint64_t)) {
+      LOG_DEBUG("I/O error while writing the free page map");
+      return;
+    }
+  }
+  if (fsync(fpm_fd_) < 0) {
+    LOG_DEBUG("I/O error while syncing the free page map");
   }
 }
 
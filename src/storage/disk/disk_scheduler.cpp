@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler.cpp
+//
+// Identification: src/storage/disk/disk_scheduler.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_scheduler.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+DiskScheduler::DiskScheduler(DiskManager *disk_manager, size_t num_workers) : disk_manager_(disk_manager) {
+  num_workers = std::max<size_t>(num_workers, 1);
+  for (size_t i = 0; i < num_workers; ++i) {
+    request_queues_.emplace_back(std::make_unique<Channel<std::optional<DiskRequest>>>());
+  }
+  for (size_t i = 0; i < num_workers; ++i) {
+    workers_.emplace_back(&DiskScheduler::StartWorkerThread, this, i);
+  }
+}
+
+DiskScheduler::~DiskScheduler() {
+  // Put a `std::nullopt` in every queue to signal its worker to exit once the pending requests are done.
+  for (auto &queue : request_queues_) {
+    queue->Put(std::nullopt);
+  }
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void DiskScheduler::Schedule(DiskRequest r) {
+  BUSTUB_ASSERT(r.page_id_ >= 0, "cannot schedule a request for an invalid page");
+  request_queues_[static_cast<size_t>(r.page_id_) % request_queues_.size()]->Put(std::move(r));
+}
+
+void DiskScheduler::ReadPage(page_id_t page_id, char *page_data) {
+  auto promise = CreatePromise();
+  auto future = promise.get_future();
+  Schedule({false, page_data, page_id, std::move(promise)});
+  future.wait();
+}
+
+void DiskScheduler::WritePage(page_id_t page_id, const char *page_data) { ScheduleWrite(page_id, page_data).wait(); }
+
+auto DiskScheduler::ScheduleWrite(page_id_t page_id, const char *page_data) -> std::future<bool> {
+  auto promise = CreatePromise();
+  auto future = promise.get_future();
+  // The data of a write request is only ever read from.
+  Schedule({true, const_cast<char *>(page_data), page_id, std::move(promise)});  // NOLINT
+  return future;
+}
+
+void DiskScheduler::WritePages(std::vector<std::pair<page_id_t, char *>> pages) {
+  std::sort(pages.begin(), pages.end());
+  std::vector<std::future<bool>> writes;
+  for (size_t first = 0; first < pages.size();) {
+    size_t last = first + 1;
+    while (last < pages.size() && last - first < static_cast<size_t>(MAX_COALESCED_WRITE) &&
+           pages[last].first == pages[last - 1].first + 1) {
+      last++;
+    }
+    auto promise = CreatePromise();
+    writes.emplace_back(promise.get_future());
+    DiskRequest request{true, pages[first].second, pages[first].first, std::move(promise)};
+    for (size_t i = first + 1; i < last; ++i) {
+      request.next_data_.push_back(pages[i].second);
+    }
+    Schedule(std::move(request));
+    first = last;
+  }
+  for (auto &write : writes) {
+    write.wait();
+  }
+}
+
+void DiskScheduler::StartWorkerThread(size_t worker) {
+  auto &queue = *request_queues_[worker];
+  while (auto request = queue.Get()) {
+    if (request->is_write_ && !request->next_data_.empty()) {
+      std::vector<const char *> pages{request->data_};
+      pages.insert(pages.end(), request->next_data_.begin(), request->next_data_.end());
+      disk_manager_->WritePages(request->page_id_, pages);
+    } else if (request->is_write_) {
+      disk_manager_->WritePage(request->page_id_, request->data_);
+    } else {
+      disk_manager_->ReadPage(request->page_id_, request->data_);
+    }
+    request->callback_.set_value(true);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_page_map.cpp
+//
+// Identification: src/storage/disk/free_page_map.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/free_page_map.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void FreePageMap::Free(page_id_t page_id) {
+  BUSTUB_ASSERT(page_id >= 0, "invalid page id");
+  auto word = WordOf(page_id);
+  if (word >= words_.size()) {
+    words_.resize(word + 1, 0);
+  }
+  auto bit = uint64_t{1} << (static_cast<size_t>(page_id) % BITS_PER_WORD);
+  if ((words_[word] & bit) == 0) {
+    words_[word] |= bit;
+    num_free_++;
+    first_word_ = std::min(first_word_, word);
+  }
+}
+
+auto FreePageMap::Take(uint32_t num_stripes, uint32_t stripe) -> page_id_t {
+  if (num_free_ == 0) {
+    return INVALID_PAGE_ID;
+  }
+  bool skipped_only_zeros = true;
+  for (size_t word = first_word_; word < words_.size(); ++word) {
+    if (words_[word] == 0) {
+      if (skipped_only_zeros) {
+        first_word_ = word + 1;
+      }
+      continue;
+    }
+    skipped_only_zeros = false;
+    for (auto bits = words_[word]; bits != 0; bits &= bits - 1) {
+      auto page_id = static_cast<page_id_t>(word * BITS_PER_WORD + __builtin_ctzll(bits));
+      if (static_cast<uint32_t>(page_id) % num_stripes == stripe) {
+        words_[word] &= ~(uint64_t{1} << __builtin_ctzll(bits));
+        num_free_--;
+        return page_id;
+      }
+    }
+  }
+  return INVALID_PAGE_ID;
+}
+
+auto FreePageMap::IsFree(page_id_t page_id) const -> bool {
+  auto word = WordOf(page_id);
+  return page_id >= 0 && word < words_.size() &&
+         (words_[word] & (uint64_t{1} << (static_cast<size_t>(page_id) % BITS_PER_WORD))) != 0;
+}
+
+auto FreePageMap::GetEnd() const -> page_id_t {
+  for (size_t word = words_.size(); word > 0; --word) {
+    if (words_[word - 1] != 0) {
+      return static_cast<page_id_t>(word * BITS_PER_WORD - __builtin_clzll(words_[word - 1]));
+    }
+  }
+  return 0;
+}
+
+void FreePageMap::Load(std::vector<uint64_t> words) {
+  words_ = std::move(words);
+  num_free_ = 0;
+  for (auto word : words_) {
+    num_free_ += __builtin_popcountll(word);
+  }
+  first_word_ = 0;
+}
+
+}  // namespace bustub
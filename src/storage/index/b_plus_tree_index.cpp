@@ -9,6 +9,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <queue>
+#include <thread>  // NOLINT
+
 #include "storage/index/b_plus_tree_index.h"
 
 namespace bustub {
@@ -20,8 +24,11 @@ BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata,
     : Index(std::move(metadata)), comparator_(GetMetadata()->GetKeySchema()) {
   page_id_t header_page_id;
   buffer_pool_manager->NewPage(&header_page_id);
-  container_ = std::make_shared<BPlusTree<KeyType, ValueType, KeyComparator>>(GetMetadata()->GetName(), header_page_id,
-                                                                              buffer_pool_manager, comparator_);
+  // Fill whole pages of the database's page size.
+  auto page_size = buffer_pool_manager->GetPageSize();
+  container_ = std::make_shared<BPlusTree<KeyType, ValueType, KeyComparator>>(
+      GetMetadata()->GetName(), header_page_id, buffer_pool_manager, comparator_, LEAF_PAGE_SLOT_CNT(page_size),
+      INTERNAL_PAGE_SLOT_CNT(page_size));
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -51,6 +58,54 @@ void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, T
   container_->GetValue(index_key, result, transaction);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::BulkLoad(std::vector<std::vector<std::pair<KeyType, ValueType>>> *runs,
+                                    Transaction *transaction) {
+  auto less = [this](const auto &lhs, const auto &rhs) { return comparator_(lhs.first, rhs.first) < 0; };
+  // Entries with equal keys keep the order they were scanned in, within a run and, by the run order, across runs.
+  std::vector<std::vector<std::pair<KeyType, ValueType>> *> non_empty_runs;
+  for (auto &run : *runs) {
+    if (!run.empty()) {
+      non_empty_runs.push_back(&run);
+    }
+  }
+  if (non_empty_runs.size() == 1) {
+    std::stable_sort(non_empty_runs[0]->begin(), non_empty_runs[0]->end(), less);
+  } else {
+    std::vector<std::thread> threads;
+    for (auto *run : non_empty_runs) {
+      threads.emplace_back([run, &less] { std::stable_sort(run->begin(), run->end(), less); });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+
+  // Merge the runs, keeping the position in every run that is not exhausted on a heap ordered by its current key.
+  using Cursor = std::pair<size_t, size_t>;
+  auto greater = [&](const Cursor &lhs, const Cursor &rhs) {
+    if (less((*runs)[rhs.first][rhs.second], (*runs)[lhs.first][lhs.second])) {
+      return true;
+    }
+    return !less((*runs)[lhs.first][lhs.second], (*runs)[rhs.first][rhs.second]) && lhs.first > rhs.first;
+  };
+  std::priority_queue<Cursor, std::vector<Cursor>, decltype(greater)> heads(greater);
+  for (size_t i = 0; i < runs->size(); i++) {
+    if (!(*runs)[i].empty()) {
+      heads.emplace(i, 0);
+    }
+  }
+  while (!heads.empty()) {
+    auto [run, pos] = heads.top();
+    heads.pop();
+    const auto &[key, value] = (*runs)[run][pos];
+    container_->Insert(key, value, transaction);
+    if (pos + 1 < (*runs)[run].size()) {
+      heads.emplace(run, pos + 1);
+    }
+  }
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::GetBeginIterator() -> INDEXITERATOR_TYPE { return container_->Begin(); }
 
@@ -89,6 +89,35 @@ auto TablePage::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, Lock
   return true;
 }
 
+auto TablePage::InsertTuples(const std::vector<Tuple> &tuples, size_t first, std::vector<RID> *rids,
+                             Transaction *txn, LockManager *lock_manager, LogManager *log_manager) -> size_t {
+  // Unlike repeated InsertTuple calls, the search for empty slots resumes where the previous tuple went.
+  uint32_t slot = 0;
+  size_t next = first;
+  for (; next < tuples.size(); next++) {
+    const auto &tuple = tuples[next];
+    BUSTUB_ASSERT(tuple.size_ > 0, "Cannot have empty tuples.");
+    if (GetFreeSpaceRemaining() < tuple.size_ + SIZE_TUPLE) {
+      break;
+    }
+    while (slot < GetTupleCount() && GetTupleSize(slot) != 0) {
+      slot++;
+    }
+
+    SetFreeSpacePointer(GetFreeSpacePointer() - tuple.size_);
+    memcpy(GetData() + GetFreeSpacePointer(), tuple.data_, tuple.size_);
+    SetTupleOffsetAtSlot(slot, GetFreeSpacePointer());
+    SetTupleSize(slot, tuple.size_);
+    rids->emplace_back(GetTablePageId(), slot);
+    if (slot == GetTupleCount()) {
+      SetTupleCount(GetTupleCount() + 1);
+    }
+  }
+  // As in InsertTuple, the write of the log record is disabled until the recovery project uses it again; the whole
+  // batch would then share one record.
+  return next - first;
+}
+
 auto TablePage::MarkDelete(const RID &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager)
     -> bool {
   uint32_t slot_num = rid.GetSlotNum();
@@ -162,14 +191,8 @@ auto TablePage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID
 
   // Copy out the old value.
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  old_tuple->size_ = tuple_size;
-  if (old_tuple->allocated_) {
-    delete[] old_tuple->data_;
-  }
-  old_tuple->data_ = new char[old_tuple->size_];
-  memcpy(old_tuple->data_, GetData() + tuple_offset, old_tuple->size_);
+  old_tuple->CopyData(GetData() + tuple_offset, tuple_size);
   old_tuple->rid_ = rid;
-  old_tuple->allocated_ = true;
 
   /**
    * Removed to support new lock manager API for p4 (multilevel locking); Big hack energy
@@ -208,7 +231,7 @@ auto TablePage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID
   return true;
 }
 
-void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager) {
+void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_manager, Tuple *deleted_tuple) {
   uint32_t slot_num = rid.GetSlotNum();
   BUSTUB_ASSERT(slot_num < GetTupleCount(), "Cannot have more slots than tuples.");
 
@@ -222,11 +245,11 @@ void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_ma
 
   // We need to copy out the deleted tuple for undo purposes.
   Tuple delete_tuple;
-  delete_tuple.size_ = tuple_size;
-  delete_tuple.data_ = new char[delete_tuple.size_];
-  memcpy(delete_tuple.data_, GetData() + tuple_offset, delete_tuple.size_);
+  delete_tuple.CopyData(GetData() + tuple_offset, tuple_size);
   delete_tuple.rid_ = rid;
-  delete_tuple.allocated_ = true;
+  if (deleted_tuple != nullptr) {
+    *deleted_tuple = delete_tuple;
+  }
 
   /**
    * Removed to support new lock manager API for p4 (multilevel locking); Big hack energy
@@ -313,16 +336,33 @@ auto TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockMan
   //    }
   //  }
 
-  // At this point, we have at least a shared lock on the RID. Copy the tuple data into our result.
-  uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  tuple->size_ = tuple_size;
-  if (tuple->allocated_) {
-    delete[] tuple->data_;
-  }
-  tuple->data_ = new char[tuple->size_];
-  memcpy(tuple->data_, GetData() + tuple_offset, tuple->size_);
+  // At this point, we have at least a shared lock on the RID. Copy the tuple data into our result. A tuple that is
+  // read into repeatedly, like the one of a TableIterator, keeps its buffer.
+  tuple->CopyData(GetData() + GetTupleOffsetAtSlot(slot_num), tuple_size);
   tuple->rid_ = rid;
-  tuple->allocated_ = true;
+  return true;
+}
+
+auto TablePage::Vacuum() -> uint32_t {
+  uint32_t tuple_count = GetTupleCount();
+  uint32_t num_slots = tuple_count;
+  while (num_slots > 0 && GetTupleSize(num_slots - 1) == 0) {
+    num_slots--;
+  }
+  SetTupleCount(num_slots);
+  return (tuple_count - num_slots) * SIZE_TUPLE;
+}
+
+auto TablePage::BorrowTuple(const RID &rid, Tuple *tuple) -> bool {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount()) {
+    return false;
+  }
+  uint32_t tuple_size = GetTupleSize(slot_num);
+  if (IsDeleted(tuple_size)) {
+    return false;
+  }
+  *tuple = Tuple(rid, GetData() + GetTupleOffsetAtSlot(slot_num), tuple_size);
   return true;
 }
 
@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.cpp
+//
+// Identification: src/storage/table/free_space_map.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/free_space_map.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace bustub {
+
+FreeSpaceMap::FreeSpaceMap(size_t page_size) : page_size_(page_size) {}
+
+void FreeSpaceMap::Update(page_id_t page_id, size_t free_bytes) {
+  std::scoped_lock lock(latch_);
+  auto it = leaf_of_.find(page_id);
+  if (it == leaf_of_.end()) {
+    if (page_ids_.size() == capacity_) {
+      Grow();
+    }
+    it = leaf_of_.emplace(page_id, page_ids_.size()).first;
+    page_ids_.push_back(page_id);
+  }
+  // Round down, an entry never promises more room than the page had.
+  auto node = capacity_ + it->second;
+  tree_[node] = static_cast<uint8_t>(std::min(free_bytes * NUM_CATEGORIES / page_size_, NUM_CATEGORIES - 1));
+  for (node /= 2; node > 0; node /= 2) {
+    tree_[node] = std::max(tree_[2 * node], tree_[2 * node + 1]);
+  }
+}
+
+auto FreeSpaceMap::Search(size_t bytes) -> page_id_t {
+  std::scoped_lock lock(latch_);
+  // Round up, any page in the category has at least `bytes` free.
+  auto category = (bytes * NUM_CATEGORIES + page_size_ - 1) / page_size_;
+  if (page_ids_.empty() || category >= NUM_CATEGORIES || tree_[1] < category) {
+    return INVALID_PAGE_ID;
+  }
+  auto leaf = FindFrom(1, 0, capacity_, next_leaf_, category);
+  if (leaf == NOT_FOUND) {
+    leaf = FindFrom(1, 0, capacity_, 0, category);
+  }
+  next_leaf_ = (leaf + 1) % page_ids_.size();
+  return page_ids_[leaf];
+}
+
+void FreeSpaceMap::Remove(page_id_t page_id) {
+  std::scoped_lock lock(latch_);
+  auto it = leaf_of_.find(page_id);
+  if (it == leaf_of_.end()) {
+    return;
+  }
+  // The leaf stays, empty, so that no other leaf moves; a page that comes back gets a new one.
+  page_ids_[it->second] = INVALID_PAGE_ID;
+  auto node = capacity_ + it->second;
+  leaf_of_.erase(it);
+  tree_[node] = 0;
+  for (node /= 2; node > 0; node /= 2) {
+    tree_[node] = std::max(tree_[2 * node], tree_[2 * node + 1]);
+  }
+}
+
+auto FreeSpaceMap::Contains(page_id_t page_id) -> bool {
+  std::scoped_lock lock(latch_);
+  return leaf_of_.count(page_id) > 0;
+}
+
+auto FreeSpaceMap::GetPageIds() -> std::vector<page_id_t> {
+  std::scoped_lock lock(latch_);
+  std::vector<page_id_t> page_ids;
+  page_ids.reserve(leaf_of_.size());
+  std::copy_if(page_ids_.begin(), page_ids_.end(), std::back_inserter(page_ids),
+               [](page_id_t page_id) { return page_id != INVALID_PAGE_ID; });
+  return page_ids;
+}
+
+auto FreeSpaceMap::GetNumPages() -> size_t {
+  std::scoped_lock lock(latch_);
+  return leaf_of_.size();
+}
+
+auto FreeSpaceMap::FindFrom(size_t node, size_t lo, size_t hi, size_t from, uint8_t category) -> size_t {
+  if (hi <= from || tree_[node] < category) {
+    return NOT_FOUND;
+  }
+  if (hi - lo == 1) {
+    return lo;
+  }
+  auto mid = lo + (hi - lo) / 2;
+  auto leaf = FindFrom(2 * node, lo, mid, from, category);
+  return leaf != NOT_FOUND ? leaf : FindFrom(2 * node + 1, mid, hi, from, category);
+}
+
+void FreeSpaceMap::Grow() {
+  auto capacity = std::max<size_t>(2 * capacity_, 1);
+  std::vector<uint8_t> tree(2 * capacity, 0);
+  std::copy(tree_.begin() + capacity_, tree_.end(), tree.begin() + capacity);
+  for (auto node = capacity - 1; node > 0; --node) {
+    tree[node] = std::max(tree[2 * node], tree[2 * node + 1]);
+  }
+  capacity_ = capacity;
+  tree_ = std::move(tree);
+}
+
+}  // namespace bustub
@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// overflow_store.cpp
+//
+// Identification: src/storage/table/overflow_store.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <memory>
+
+#include "common/macros.h"
+#include "storage/page/overflow_page.h"
+#include "storage/table/overflow_store.h"
+
+namespace bustub {
+
+auto OverflowStore::Write(const char *data, uint32_t length, OverflowPointer *pointer) -> bool {
+  const auto capacity = OverflowPage::Capacity(buffer_pool_manager_->GetPageSize());
+  const auto num_pieces = std::max<size_t>((length + capacity - 1) / capacity, 1);
+  // Write the last piece first, so that every page is complete when it is written.
+  page_id_t next_page_id = INVALID_PAGE_ID;
+  for (auto i = num_pieces; i-- > 0;) {
+    page_id_t page_id;
+    auto page = buffer_pool_manager_->NewPage(&page_id);
+    if (page == nullptr) {
+      if (next_page_id != INVALID_PAGE_ID) {
+        Free(next_page_id);
+      }
+      return false;
+    }
+    auto offset = i * capacity;
+    auto piece_size = static_cast<uint32_t>(std::min<size_t>(capacity, length - offset));
+    reinterpret_cast<OverflowPage *>(page->GetData())->Init(next_page_id, data + offset, piece_size);
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    next_page_id = page_id;
+  }
+  *pointer = {next_page_id, length};
+  return true;
+}
+
+auto OverflowStore::Read(const OverflowPointer &pointer) const -> Value {
+  // A chain never changes after it is written, so it is read without latches.
+  auto data = std::make_unique<char[]>(pointer.length_);
+  uint32_t offset = 0;
+  for (auto page_id = pointer.first_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto page = buffer_pool_manager_->FetchPage(page_id);
+    BUSTUB_ENSURE(page != nullptr, "BPM full");
+    auto overflow_page = reinterpret_cast<const OverflowPage *>(page->GetData());
+    BUSTUB_ASSERT(offset + overflow_page->GetPieceSize() <= pointer.length_, "overflow chain longer than its value");
+    memcpy(data.get() + offset, overflow_page->GetPiece(), overflow_page->GetPieceSize());
+    offset += overflow_page->GetPieceSize();
+    auto next_page_id = overflow_page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  return {TypeId::VARCHAR, data.get(), pointer.length_, true};
+}
+
+void OverflowStore::Free(page_id_t first_page_id) {
+  for (auto page_id = first_page_id; page_id != INVALID_PAGE_ID;) {
+    auto page = buffer_pool_manager_->FetchPage(page_id);
+    BUSTUB_ENSURE(page != nullptr, "BPM full");
+    auto next_page_id = reinterpret_cast<const OverflowPage *>(page->GetData())->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    buffer_pool_manager_->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+}
+
+}  // namespace bustub
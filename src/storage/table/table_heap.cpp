@@ -10,7 +10,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
 
 #include "common/logger.h"
 #include "fmt/format.h"
@@ -19,76 +26,426 @@
 namespace bustub {
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-                     page_id_t first_page_id)
+                     page_id_t first_page_id, const Schema *schema)
     : buffer_pool_manager_(buffer_pool_manager),
       lock_manager_(lock_manager),
       log_manager_(log_manager),
-      first_page_id_(first_page_id) {}
+      schema_(schema == nullptr ? nullptr : std::make_unique<const Schema>(*schema)),
+      overflow_store_(buffer_pool_manager, schema_.get()),
+      first_page_id_(first_page_id),
+      free_space_map_(buffer_pool_manager->GetPageSize()) {
+  // Rebuild the free space map of the existing table.
+  for (auto page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id, AccessType::Scan));
+    BUSTUB_ASSERT(page != nullptr, "Couldn't fetch a page of the table heap.");
+    page->RLatch();
+    free_space_map_.Update(page_id, page->GetFreeSpaceRemaining());
+    auto next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false, AccessType::Scan);
+    last_page_id_ = page_id;
+    page_id = next_page_id;
+  }
+}
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-                     Transaction *txn)
-    : buffer_pool_manager_(buffer_pool_manager), lock_manager_(lock_manager), log_manager_(log_manager) {
+                     Transaction *txn, const Schema *schema)
+    : buffer_pool_manager_(buffer_pool_manager),
+      lock_manager_(lock_manager),
+      log_manager_(log_manager),
+      schema_(schema == nullptr ? nullptr : std::make_unique<const Schema>(*schema)),
+      overflow_store_(buffer_pool_manager, schema_.get()),
+      free_space_map_(buffer_pool_manager->GetPageSize()) {
   // Initialize the first table page.
   auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(&first_page_id_));
   BUSTUB_ASSERT(first_page != nullptr,
                 "Couldn't create a page for the table heap. Have you completed the buffer pool manager project?");
-  first_page->Init(first_page_id_, BUSTUB_PAGE_SIZE, INVALID_LSN, log_manager_, txn);
+  first_page->Init(first_page_id_, buffer_pool_manager_->GetPageSize(), INVALID_LSN, log_manager_, txn);
+  free_space_map_.Update(first_page_id_, first_page->GetFreeSpaceRemaining());
+  last_page_id_ = first_page_id_;
   buffer_pool_manager_->UnpinPage(first_page_id_, true);
 }
 
 auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool {
-  if (tuple.size_ + 32 > BUSTUB_PAGE_SIZE) {  // larger than one page size
+  Tuple spilled;
+  auto stored = SpillLargeValues(tuple, &spilled);
+  if (stored == nullptr) {  // larger than one page size
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
 
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+  // Try the pages the free space map offers; a page that turns out to be full gets its entry corrected and is not
+  // offered again. Extend the table once no page has room.
+  auto footprint = TablePage::GetTupleFootprint(*stored);
+  while (true) {
+    auto page = FetchPageWithRoom(footprint, txn);
+    // If no page could be found or created, then life sucks and we abort the transaction.
+    if (page == nullptr) {
+      FreeOverflow(*stored);
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    page->WLatch();
+    auto page_id = page->GetTablePageId();
+    bool is_inserted = page->InsertTuple(*stored, rid, txn, lock_manager_, log_manager_);
+    free_space_map_.Update(page_id, page->GetFreeSpaceRemaining());
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, is_inserted);
+    if (is_inserted) {
+      break;
+    }
+  }
+  // Update the transaction's write set.
+  txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
+  return true;
+}
+
+auto TableHeap::InsertTuples(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn) -> bool {
+  // Only copy the batch if a tuple has large varchars to move out.
+  std::vector<Tuple> spilled_tuples;
+  size_t total_footprint = 0;
+  for (size_t i = 0; i < tuples.size(); i++) {
+    Tuple spilled;
+    auto stored = SpillLargeValues(tuples[i], &spilled);
+    if (stored == nullptr) {  // larger than one page size
+      for (const auto &tuple : spilled_tuples) {
+        FreeOverflow(tuple);
+      }
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    if (stored == &spilled && spilled_tuples.empty()) {
+      spilled_tuples.assign(tuples.begin(), tuples.begin() + i);
+    }
+    if (stored == &spilled || !spilled_tuples.empty()) {
+      spilled_tuples.push_back(*stored);
+    }
+    total_footprint += TablePage::GetTupleFootprint(*stored);
+  }
+  const auto &batch = spilled_tuples.empty() ? tuples : spilled_tuples;
+
+  size_t next = 0;
+  while (next < batch.size()) {
+    // If the table has to grow, append enough pages for the rest of the batch right away.
+    auto page = FetchPageWithRoom(TablePage::GetTupleFootprint(batch[next]), txn,
+                                  total_footprint / buffer_pool_manager_->GetPageSize() + 1);
+    if (page == nullptr) {
+      // The tuples inserted so far are in the write set and their overflow pages go with the abort.
+      for (auto i = next; i < batch.size(); i++) {
+        FreeOverflow(batch[i]);
+      }
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    page->WLatch();
+    auto page_id = page->GetTablePageId();
+    auto first_rid = rids->size();
+    auto num_inserted = page->InsertTuples(batch, next, rids, txn, lock_manager_, log_manager_);
+    free_space_map_.Update(page_id, page->GetFreeSpaceRemaining());
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, num_inserted > 0);
+
+    // Update the transaction's write set.
+    for (auto i = first_rid; i < rids->size(); i++) {
+      txn->GetWriteSet()->emplace_back((*rids)[i], WType::INSERT, Tuple{}, this);
+    }
+    for (auto i = next; i < next + num_inserted; i++) {
+      total_footprint -= TablePage::GetTupleFootprint(batch[i]);
+    }
+    next += num_inserted;
+  }
+  return true;
+}
+
+auto TableHeap::FetchPageWithRoom(size_t footprint, Transaction *txn, size_t min_pages) -> TablePage * {
+  std::shared_lock lock(vacuum_latch_);
+  auto page_id = free_space_map_.Search(footprint);
+  if (page_id == INVALID_PAGE_ID) {
+    page_id = ExtendHeap(footprint, txn, min_pages);
+  }
+  if (page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  return static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+}
+
+auto TableHeap::SpillLargeValues(const Tuple &tuple, Tuple *spilled) -> const Tuple * {
+  const auto page_size = buffer_pool_manager_->GetPageSize();
+  if (schema_ == nullptr) {
+    return tuple.size_ + 32 > page_size ? nullptr : &tuple;
+  }
+
+  // Pick the varchars to move, longest first: every one above the threshold, and more while the row is too large.
+  // Moving a varchar no longer than its pointer gains nothing.
+  std::vector<std::pair<uint32_t, uint32_t>> lengths;
+  bool has_overflow = false;
+  for (auto column_idx : schema_->GetUnlinedColumns()) {
+    auto length = *reinterpret_cast<const uint32_t *>(tuple.GetDataPtr(schema_.get(), column_idx));
+    has_overflow = has_overflow || length == BUSTUB_VALUE_OVERFLOW;
+    if (length != BUSTUB_VALUE_NULL && length != BUSTUB_VALUE_OVERFLOW && length > sizeof(OverflowPointer)) {
+      lengths.emplace_back(length, column_idx);
+    }
+  }
+  std::sort(lengths.begin(), lengths.end(), std::greater<>());
+  std::vector<bool> to_spill(schema_->GetColumnCount(), false);
+  const auto threshold = page_size / OVERFLOW_THRESHOLD_RATIO;
+  auto size = tuple.size_;
+  bool has_spill = false;
+  for (auto [length, column_idx] : lengths) {
+    if (length <= threshold && size + 32 <= page_size) {
+      break;
+    }
+    to_spill[column_idx] = true;
+    has_spill = true;
+    size -= length - sizeof(OverflowPointer);
+  }
+  if (size + 32 > page_size) {  // larger than one page size
+    return nullptr;
+  }
+  if (!has_spill && !has_overflow) {
+    return &tuple;
+  }
+
+  // Lay the tuple out again, in column order, with a pointer in place of every value on overflow pages. It only
+  // shrinks, so the old size is enough room.
+  std::vector<char> data(tuple.size_);
+  memcpy(data.data(), tuple.data_, schema_->GetLength());
+  uint32_t offset = schema_->GetLength();
+  std::vector<page_id_t> chains;
+  for (auto column_idx : schema_->GetUnlinedColumns()) {
+    memcpy(data.data() + schema_->GetColumn(column_idx).GetOffset(), &offset, sizeof(uint32_t));
+    const char *payload = tuple.GetDataPtr(schema_.get(), column_idx);
+    auto length = *reinterpret_cast<const uint32_t *>(payload);
+    if (!to_spill[column_idx] && length != BUSTUB_VALUE_OVERFLOW) {
+      auto payload_size = sizeof(uint32_t) + (length == BUSTUB_VALUE_NULL ? 0 : length);
+      memcpy(data.data() + offset, payload, payload_size);
+      offset += payload_size;
+      continue;
+    }
+
+    OverflowPointer pointer;
+    bool is_written;
+    if (tuple.GetOverflowPointer(schema_.get(), column_idx, &pointer)) {
+      auto value = overflow_store_.Read(pointer);
+      is_written = overflow_store_.Write(value.GetData(), value.GetLength(), &pointer);
+    } else {
+      is_written = overflow_store_.Write(payload + sizeof(uint32_t), length, &pointer);
+    }
+    if (!is_written) {
+      for (auto first_page_id : chains) {
+        overflow_store_.Free(first_page_id);
+      }
+      return nullptr;
+    }
+    chains.push_back(pointer.first_page_id_);
+    memcpy(data.data() + offset, &BUSTUB_VALUE_OVERFLOW, sizeof(uint32_t));
+    memcpy(data.data() + offset + sizeof(uint32_t), &pointer, sizeof(OverflowPointer));
+    offset += sizeof(uint32_t) + sizeof(OverflowPointer);
+  }
+  spilled->CopyData(data.data(), offset);
+  spilled->rid_ = tuple.rid_;
+  return spilled;
+}
+
+void TableHeap::FreeOverflow(const Tuple &tuple) {
+  if (schema_ == nullptr || tuple.data_ == nullptr) {
+    return;
+  }
+  for (auto column_idx : schema_->GetUnlinedColumns()) {
+    if (OverflowPointer pointer; tuple.GetOverflowPointer(schema_.get(), column_idx, &pointer)) {
+      overflow_store_.Free(pointer.first_page_id_);
+    }
+  }
+}
+
+void TableHeap::RetireOverflow(const Tuple &tuple) {
+  if (schema_ == nullptr || tuple.data_ == nullptr) {
+    return;
+  }
+  for (auto column_idx : schema_->GetUnlinedColumns()) {
+    if (OverflowPointer pointer; tuple.GetOverflowPointer(schema_.get(), column_idx, &pointer)) {
+      std::scoped_lock lock(retired_overflow_latch_);
+      retired_overflow_.push_back(pointer.first_page_id_);
+    }
+  }
+}
+
+auto TableHeap::ExtendHeap(size_t footprint, Transaction *txn, size_t min_pages) -> page_id_t {
+  extend_waiters_++;
+  std::scoped_lock lock(extend_latch_);
+  size_t num_pages = std::min(std::max(extend_waiters_.fetch_sub(1), min_pages), MAX_EXTEND_PAGES);
+  // Another inserter may have extended the table while this one was waiting.
+  auto page_id = free_space_map_.Search(footprint);
+  if (page_id != INVALID_PAGE_ID) {
+    return page_id;
+  }
+
+  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(last_page_id_));
   if (cur_page == nullptr) {
-    txn->SetState(TransactionState::ABORTED);
-    return false;
+    return INVALID_PAGE_ID;
   }
+  cur_page->WLatch();
+  for (size_t i = 0; i < num_pages; ++i) {
+    page_id_t next_page_id;
+    auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&next_page_id));
+    // If we could not create a new page, make do with the ones we have.
+    if (new_page == nullptr) {
+      break;
+    }
+    new_page->WLatch();
+    cur_page->SetNextPageId(next_page_id);
+    new_page->Init(next_page_id, buffer_pool_manager_->GetPageSize(), cur_page->GetTablePageId(), log_manager_, txn);
+    free_space_map_.Update(next_page_id, new_page->GetFreeSpaceRemaining());
+    cur_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
+    cur_page = new_page;
+    page_id = page_id == INVALID_PAGE_ID ? next_page_id : page_id;
+  }
+  last_page_id_ = cur_page->GetTablePageId();
+  cur_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(last_page_id_, true);
+  return page_id;
+}
 
+auto TableHeap::GetScanThreads(size_t num_threads) -> size_t {
+  // Every thread pins at most a table page and an overflow page at once; leave most of the pool to everyone else.
+  num_threads = std::min(num_threads, buffer_pool_manager_->GetPoolSize() / 4);
+  // Every thread keeps the page after its current one read ahead. The pool caps how many prefetched pages it holds
+  // by the read-ahead window, and more threads would recycle each other's pages before reading them.
+  if (auto window = buffer_pool_manager_->GetReadAheadWindow(); window > 0) {
+    num_threads = std::min(num_threads, window);
+  }
+  return std::max<size_t>(num_threads, 1);
+}
+
+void TableHeap::ParallelScan(size_t num_threads, const std::function<void(size_t, const Tuple &)> &visit) {
+  // The free space map tracks every page of the heap, so the pages are split up without walking the chain.
+  const auto page_ids = free_space_map_.GetPageIds();
+  num_threads = std::min(GetScanThreads(num_threads), std::max<size_t>(page_ids.size(), 1));
+  auto scan_range = [&](size_t thread) {
+    const auto begin = page_ids.size() * thread / num_threads;
+    const auto end = page_ids.size() * (thread + 1) / num_threads;
+    std::vector<Tuple> tuples;
+    for (auto i = begin; i < end; i++) {
+      TablePage *page;
+      {
+        // Vacuum takes the page out of the map before it releases it, and only while it holds vacuum_latch_
+        // exclusively, so a page that is still in the map stays part of the heap once it is pinned.
+        std::shared_lock lock(vacuum_latch_);
+        if (!free_space_map_.Contains(page_ids[i])) {
+          continue;
+        }
+        page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_ids[i], AccessType::Scan));
+      }
+      BUSTUB_ENSURE(page != nullptr, "BPM full");
+      if (i + 1 < end) {
+        buffer_pool_manager_->ReadAheadHint(page_ids[i], page_ids[i + 1], nullptr);
+      }
+      // Copy the tuples of the page out and release it, so that visit may fetch pages itself.
+      page->RLatch();
+      size_t num_tuples = 0;
+      RID rid;
+      for (bool found = page->GetFirstTupleRid(&rid); found;) {
+        if (Tuple borrowed; page->BorrowTuple(rid, &borrowed)) {
+          if (num_tuples == tuples.size()) {
+            tuples.emplace_back();
+          }
+          auto &tuple = tuples[num_tuples++];
+          tuple.rid_ = rid;
+          tuple.CopyData(borrowed.data_, borrowed.size_);
+          tuple.overflow_store_ = &overflow_store_;
+        }
+        RID next_rid;
+        found = page->GetNextTupleRid(rid, &next_rid);
+        rid = next_rid;
+      }
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page_ids[i], false, AccessType::Scan);
+      for (size_t j = 0; j < num_tuples; j++) {
+        visit(thread, tuples[j]);
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t thread = 1; thread < num_threads; thread++) {
+    threads.emplace_back(scan_range, thread);
+  }
+  scan_range(0);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+auto TableHeap::Vacuum() -> VacuumStats {
+  VacuumStats stats;
+  std::vector<page_id_t> retired;
+  {
+    std::scoped_lock lock(retired_overflow_latch_);
+    retired.swap(retired_overflow_);
+  }
+  for (auto first_page_id : retired) {
+    overflow_store_.Free(first_page_id);
+  }
+  stats.released_overflow_chains_ = retired.size();
+  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+  if (cur_page == nullptr) {
+    return stats;
+  }
   cur_page->WLatch();
+  stats.reclaimed_bytes_ += cur_page->Vacuum();
+  free_space_map_.Update(first_page_id_, cur_page->GetFreeSpaceRemaining());
+  stats.pages_++;
 
-  // Insert into the first page with enough space. If no such page exists, create a new page and insert into that.
-  // INVARIANT: cur_page is WLatched if you leave the loop normally.
-  while (!cur_page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_)) {
+  // Walk the list latching hand over hand, so that readers never see a page that is unlinked under them.
+  while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
     auto next_page_id = cur_page->GetNextPageId();
-    // If the next page is a valid page,
-    if (next_page_id != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
-      next_page->WLatch();
-      // Unlatch and unpin the current page.
-      cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
-      cur_page = next_page;
-    } else {
-      // Otherwise we have run out of valid pages. We need to create a new page.
-      auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&next_page_id));
-      // If we could not create a new page,
-      if (new_page == nullptr) {
-        // Then life sucks and we abort the transaction.
-        cur_page->WUnlatch();
-        buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
-        txn->SetState(TransactionState::ABORTED);
-        return false;
+    auto next_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
+    if (next_page == nullptr) {
+      break;
+    }
+    next_page->WLatch();
+    auto reclaimed_bytes = next_page->Vacuum();
+    stats.pages_++;
+
+    // An empty page can go if nobody but us has it pinned: an iterator would still be positioned on it. The last
+    // page stays, since inserters extend the table from it. Inserters between a free space map lookup and the pin of
+    // the page hold vacuum_latch_, so if it is taken, try again with the next vacuum rather than wait.
+    std::unique_lock release_lock(vacuum_latch_, std::defer_lock);
+    if (next_page->IsEmpty() && next_page->GetNextPageId() != INVALID_PAGE_ID &&
+        next_page->GetPinCount() == 1 && release_lock.try_lock()) {
+      auto after_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page->GetNextPageId()));
+      if (after_page != nullptr) {
+        after_page->WLatch();
+        after_page->SetPrevPageId(cur_page->GetTablePageId());
+        cur_page->SetNextPageId(after_page->GetTablePageId());
+        after_page->WUnlatch();
+        buffer_pool_manager_->UnpinPage(after_page->GetTablePageId(), true);
+
+        free_space_map_.Remove(next_page_id);
+        next_page->WUnlatch();
+        buffer_pool_manager_->UnpinPage(next_page_id, false);
+        // Only a reader holding a stale rid can have pinned the page since. Then the page is unlinked but not
+        // deallocated, and leaks rather than being handed out while still in use.
+        if (buffer_pool_manager_->DeletePage(next_page_id)) {
+          stats.released_pages_++;
+          stats.reclaimed_bytes_ += buffer_pool_manager_->GetPageSize();
+        }
+        continue;
       }
-      // Otherwise we were able to create a new page. We initialize it now.
-      new_page->WLatch();
-      cur_page->SetNextPageId(next_page_id);
-      new_page->Init(next_page_id, BUSTUB_PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
-      cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
-      cur_page = new_page;
     }
+    if (release_lock.owns_lock()) {
+      release_lock.unlock();
+    }
+
+    stats.reclaimed_bytes_ += reclaimed_bytes;
+    free_space_map_.Update(next_page_id, next_page->GetFreeSpaceRemaining());
+    cur_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
+    cur_page = next_page;
   }
-  // This line has caused most of us to double-take and "whoa double unlatch".
-  // We are not, in fact, double unlatching. See the invariant above.
   cur_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
-  // Update the transaction's write set.
-  txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
-  return true;
+  return stats;
 }
 
 auto TableHeap::MarkDelete(const RID &rid, Transaction *txn) -> bool {
@@ -118,12 +475,23 @@ auto TableHeap::UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
+  Tuple spilled;
+  auto stored = SpillLargeValues(tuple, &spilled);
+  if (stored == nullptr) {
+    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
   // Update the tuple; but first save the old value for rollbacks.
   Tuple old_tuple;
   page->WLatch();
-  bool is_updated = page->UpdateTuple(tuple, &old_tuple, rid, txn, lock_manager_, log_manager_);
+  bool is_updated = page->UpdateTuple(*stored, &old_tuple, rid, txn, lock_manager_, log_manager_);
+  free_space_map_.Update(rid.GetPageId(), page->GetFreeSpaceRemaining());
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), is_updated);
+  if (!is_updated) {
+    FreeOverflow(*stored);
+  }
   // Update the transaction's write set.
   if (is_updated && txn->GetState() != TransactionState::ABORTED) {
     txn->GetWriteSet()->emplace_back(rid, WType::UPDATE, old_tuple, this);
@@ -136,13 +504,35 @@ void TableHeap::ApplyDelete(const RID &rid, Transaction *txn) {
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
   BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
   // Delete the tuple from the page.
+  Tuple deleted_tuple;
   page->WLatch();
-  page->ApplyDelete(rid, txn, log_manager_);
+  page->ApplyDelete(rid, txn, log_manager_, &deleted_tuple);
+  free_space_map_.Update(rid.GetPageId(), page->GetFreeSpaceRemaining());
   /** Commented out to make compatible with p4; This is called only on commit or delete, which consequently unlocks the
    * tuple; so should be fine */
   // lock_manager_->Unlock(txn, rid);
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  RetireOverflow(deleted_tuple);
+}
+
+void TableHeap::ApplyUpdate(const Tuple &old_tuple, Transaction *txn) { RetireOverflow(old_tuple); }
+
+void TableHeap::RollbackUpdate(const Tuple &old_tuple, const RID &rid, Transaction *txn) {
+  // Find the page which contains the tuple.
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
+  // Put back the old version as it was stored, overflow pointers included.
+  Tuple new_tuple;
+  page->WLatch();
+  bool is_updated = page->UpdateTuple(old_tuple, &new_tuple, rid, txn, lock_manager_, log_manager_);
+  free_space_map_.Update(rid.GetPageId(), page->GetFreeSpaceRemaining());
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), is_updated);
+  // The version the rollback replaces is gone for good.
+  if (is_updated) {
+    RetireOverflow(new_tuple);
+  }
 }
 
 void TableHeap::RollbackDelete(const RID &rid, Transaction *txn) {
@@ -169,6 +559,7 @@ auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool ac
     page->RLatch();
   }
   bool res = page->GetTuple(rid, tuple, txn, lock_manager_);
+  tuple->overflow_store_ = &overflow_store_;
   if (acquire_read_lock) {
     page->RUnlatch();
   }
@@ -176,13 +567,36 @@ auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool ac
   return res;
 }
 
-auto TableHeap::Begin(Transaction *txn) -> TableIterator {
+auto TableHeap::GetTupleView(const RID &rid, TupleView *view) -> bool {
+  auto guard = std::make_shared<ReadPageGuard>(buffer_pool_manager_->FetchPageRead(rid.GetPageId()));
+  auto *page = guard->AsPage<TablePage>();
+  if (page == nullptr) {
+    return false;
+  }
+  Tuple tuple;
+  if (!page->BorrowTuple(rid, &tuple)) {
+    return false;
+  }
+  tuple.overflow_store_ = &overflow_store_;
+  *view = TupleView(std::move(guard), tuple);
+  return true;
+}
+
+auto TableHeap::Begin(Transaction *txn) -> TableIterator { return {this, FirstTupleRid(), txn}; }
+
+auto TableHeap::End() -> TableIterator { return {this, RID(INVALID_PAGE_ID, 0), nullptr}; }
+
+auto TableHeap::ViewBegin() -> TableViewIterator { return {this, FirstTupleRid()}; }
+
+auto TableHeap::ViewEnd() -> TableViewIterator { return {this, RID(INVALID_PAGE_ID, 0)}; }
+
+auto TableHeap::FirstTupleRid() -> RID {
   // Start an iterator from the first page.
   // TODO(Wuwen): Hacky fix for now. Removing empty pages is a better way to handle this.
   RID rid;
   auto page_id = first_page_id_;
   while (page_id != INVALID_PAGE_ID) {
-    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id, AccessType::Scan));
     page->RLatch();
     // If this fails because there is no tuple, then RID will be the default-constructed value, which means EOF.
     auto found_tuple = page->GetFirstTupleRid(&rid);
@@ -193,9 +607,7 @@ auto TableHeap::Begin(Transaction *txn) -> TableIterator {
     }
     page_id = page->GetNextPageId();
   }
-  return {this, rid, txn};
+  return rid;
 }
 
-auto TableHeap::End() -> TableIterator { return {this, RID(INVALID_PAGE_ID, 0), nullptr}; }
-
 }  // namespace bustub
@@ -18,15 +18,67 @@
 
 namespace bustub {
 
+/** Tell the buffer pool where a scan continues after the latched page, so that it reads the heap ahead of the scan. */
+static void HintReadAhead(BufferPoolManager *buffer_pool_manager, TablePage *page) {
+  buffer_pool_manager->ReadAheadHint(page->GetTablePageId(), page->GetNextPageId(), &TablePage::NextPageIdOf);
+}
+
 TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn)
     : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn) {
-  if (rid.GetPageId() != INVALID_PAGE_ID) {
-    if (!table_heap_->GetTuple(tuple_->rid_, tuple_, txn_)) {
+  tuple_->overflow_store_ = &table_heap_->overflow_store_;
+  page_ = PinPage(rid.GetPageId());
+  if (page_ != nullptr) {
+    page_->RLatch();
+    HintReadAhead(table_heap_->buffer_pool_manager_, page_);
+    bool found = page_->GetTuple(rid, tuple_, txn_, table_heap_->lock_manager_);
+    page_->RUnlatch();
+    if (!found) {
+      UnpinPage();
+      delete tuple_;
       throw bustub::Exception("read non-existing tuple");
     }
   }
 }
 
+TableIterator::TableIterator(const TableIterator &other)
+    : table_heap_(other.table_heap_), tuple_(new Tuple(*other.tuple_)), txn_(other.txn_) {
+  page_ = other.page_ == nullptr ? nullptr : PinPage(other.page_->GetTablePageId());
+}
+
+TableIterator::~TableIterator() {
+  UnpinPage();
+  delete tuple_;
+}
+
+auto TableIterator::operator=(const TableIterator &other) -> TableIterator & {
+  if (this == &other) {
+    return *this;
+  }
+  auto *page = other.page_ == nullptr ? nullptr : other.PinPage(other.page_->GetTablePageId());
+  UnpinPage();
+  table_heap_ = other.table_heap_;
+  page_ = page;
+  *tuple_ = *other.tuple_;
+  txn_ = other.txn_;
+  return *this;
+}
+
+auto TableIterator::PinPage(page_id_t page_id) const -> TablePage * {
+  if (page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  auto page = static_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(page_id, AccessType::Scan));
+  BUSTUB_ENSURE(page != nullptr, "BPM full");  // all pages are pinned
+  return page;
+}
+
+void TableIterator::UnpinPage() {
+  if (page_ != nullptr) {
+    table_heap_->buffer_pool_manager_->UnpinPage(page_->GetTablePageId(), false);
+    page_ = nullptr;
+  }
+}
+
 auto TableIterator::operator*() -> const Tuple & {
   assert(*this != table_heap_->End());
   return *tuple_;
@@ -39,19 +91,22 @@ auto TableIterator::operator->() -> Tuple * {
 
 auto TableIterator::operator++() -> TableIterator & {
   BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(tuple_->rid_.GetPageId()));
-  BUSTUB_ENSURE(cur_page != nullptr, "BPM full");  // all pages are pinned
+  // The iterator already holds the pin of the current page, which now moves along with it.
+  auto cur_page = page_;
+  page_ = nullptr;
 
   cur_page->RLatch();
   RID next_tuple_rid;
   if (!cur_page->GetNextTupleRid(tuple_->rid_,
                                  &next_tuple_rid)) {  // end of this page
     while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
+      auto next_page =
+          static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId(), AccessType::Scan));
       cur_page->RUnlatch();
       buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
       cur_page = next_page;
       cur_page->RLatch();
+      HintReadAhead(buffer_pool_manager, cur_page);
       if (cur_page->GetFirstTupleRid(&next_tuple_rid)) {
         break;
       }
@@ -59,18 +114,19 @@ auto TableIterator::operator++() -> TableIterator & {
   }
   tuple_->rid_ = next_tuple_rid;
 
-  if (*this != table_heap_->End()) {
-    // DO NOT ACQUIRE READ LOCK twice in a single thread otherwise it may deadlock.
-    // See https://users.rust-lang.org/t/how-bad-is-the-potential-deadlock-mentioned-in-rwlocks-document/67234
-    if (!table_heap_->GetTuple(tuple_->rid_, tuple_, txn_, false)) {
-      cur_page->RUnlatch();
-      buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
-      throw bustub::Exception("read non-existing tuple");
-    }
+  if (next_tuple_rid.GetPageId() == INVALID_PAGE_ID) {
+    cur_page->RUnlatch();
+    buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
+    return *this;
   }
+  // The page is latched already; do not go through TableHeap::GetTuple, which would latch it a second time.
+  page_ = cur_page;
+  bool found = cur_page->GetTuple(next_tuple_rid, tuple_, txn_, table_heap_->lock_manager_);
   // release until copy the tuple
   cur_page->RUnlatch();
-  buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
+  if (!found) {
+    throw bustub::Exception("read non-existing tuple");
+  }
   return *this;
 }
 
@@ -80,4 +136,63 @@ auto TableIterator::operator++(int) -> TableIterator {
   return clone;
 }
 
+TableViewIterator::TableViewIterator(TableHeap *table_heap, RID rid) : table_heap_(table_heap) {
+  if (rid.GetPageId() != INVALID_PAGE_ID) {
+    BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+    page_ = static_cast<TablePage *>(buffer_pool_manager->FetchPage(rid.GetPageId(), AccessType::Scan));
+    BUSTUB_ENSURE(page_ != nullptr, "BPM full");
+    page_->RLatch();
+    HintReadAhead(buffer_pool_manager, page_);
+    page_guard_ = std::make_shared<ReadPageGuard>(buffer_pool_manager, page_);
+  }
+  Borrow(rid);
+}
+
+auto TableViewIterator::operator*() -> const TupleView & {
+  assert(view_.IsValid());
+  return view_;
+}
+
+auto TableViewIterator::operator->() -> const TupleView * {
+  assert(view_.IsValid());
+  return &view_;
+}
+
+auto TableViewIterator::operator++() -> TableViewIterator & {
+  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+  RID next_tuple_rid;
+  if (!page_->GetNextTupleRid(view_.GetRid(), &next_tuple_rid)) {  // end of this page
+    while (page_->GetNextPageId() != INVALID_PAGE_ID) {
+      auto next_page =
+          static_cast<TablePage *>(buffer_pool_manager->FetchPage(page_->GetNextPageId(), AccessType::Scan));
+      BUSTUB_ENSURE(next_page != nullptr, "BPM full");
+      next_page->RLatch();
+      HintReadAhead(buffer_pool_manager, next_page);
+      // The previous page stays latched for as long as views of it are still held elsewhere.
+      page_guard_ = std::make_shared<ReadPageGuard>(buffer_pool_manager, next_page);
+      page_ = next_page;
+      if (page_->GetFirstTupleRid(&next_tuple_rid)) {
+        break;
+      }
+    }
+  }
+  Borrow(next_tuple_rid);
+  return *this;
+}
+
+void TableViewIterator::Borrow(const RID &rid) {
+  if (rid.GetPageId() == INVALID_PAGE_ID) {
+    view_.Release();
+    page_guard_.reset();
+    page_ = nullptr;
+    return;
+  }
+  Tuple tuple;
+  if (!page_->BorrowTuple(rid, &tuple)) {
+    throw bustub::Exception("read non-existing tuple");
+  }
+  tuple.overflow_store_ = &table_heap_->overflow_store_;
+  view_ = TupleView(page_guard_, tuple);
+}
+
 }  // namespace bustub
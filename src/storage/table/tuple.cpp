@@ -16,12 +16,13 @@
 #include <string>
 #include <vector>
 
+#include "storage/table/overflow_store.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 // TODO(Amadou): It does not look like nulls are supported. Add a null bitmap?
-Tuple::Tuple(std::vector<Value> values, const Schema *schema) : allocated_(true) {
+Tuple::Tuple(std::vector<Value> values, const Schema *schema, AbstractPool *pool) {
   assert(values.size() == schema->GetColumnCount());
 
   // 1. Calculate the size of the tuple.
@@ -36,7 +37,13 @@ Tuple::Tuple(std::vector<Value> values, const Schema *schema) : allocated_(true)
 
   // 2. Allocate memory.
   size_ = tuple_size;
-  data_ = new char[size_];
+  if (pool != nullptr) {
+    data_ = static_cast<char *>(pool->Allocate(size_));
+  } else {
+    allocated_ = true;
+    capacity_ = size_;
+    data_ = new char[size_];
+  }
   std::memset(data_, 0, size_);
 
   // 3. Serialize each attribute based on the input value.
@@ -61,10 +68,12 @@ Tuple::Tuple(std::vector<Value> values, const Schema *schema) : allocated_(true)
   }
 }
 
-Tuple::Tuple(const Tuple &other) : allocated_(other.allocated_), rid_(other.rid_), size_(other.size_) {
-  if (allocated_) {
-    delete[] data_;
-  }
+Tuple::Tuple(const Tuple &other)
+    : allocated_(other.allocated_),
+      rid_(other.rid_),
+      size_(other.size_),
+      capacity_(other.allocated_ ? size_ : 0),
+      overflow_store_(other.overflow_store_) {
   if (allocated_) {
     // Deep copy.
     data_ = new char[size_];
@@ -76,19 +85,23 @@ Tuple::Tuple(const Tuple &other) : allocated_(other.allocated_), rid_(other.rid_
 }
 
 auto Tuple::operator=(const Tuple &other) -> Tuple & {
-  if (allocated_) {
-    delete[] data_;
+  if (this == &other) {
+    return *this;
   }
-  allocated_ = other.allocated_;
   rid_ = other.rid_;
-  size_ = other.size_;
+  overflow_store_ = other.overflow_store_;
 
-  if (allocated_) {
+  if (other.allocated_) {
     // Deep copy.
-    data_ = new char[size_];
-    memcpy(data_, other.data_, size_);
+    CopyData(other.data_, other.size_);
   } else {
     // Shallow copy.
+    if (allocated_) {
+      delete[] data_;
+    }
+    allocated_ = false;
+    size_ = other.size_;
+    capacity_ = 0;
     data_ = other.data_;
   }
 
@@ -99,13 +112,17 @@ auto Tuple::GetValue(const Schema *schema, const uint32_t column_idx) const -> V
   assert(schema);
   assert(data_);
   const TypeId column_type = schema->GetColumn(column_idx).GetType();
+  if (OverflowPointer pointer; GetOverflowPointer(schema, column_idx, &pointer)) {
+    BUSTUB_ASSERT(overflow_store_ != nullptr, "varchar on overflow pages outside of its table heap");
+    return overflow_store_->Read(pointer);
+  }
   const char *data_ptr = GetDataPtr(schema, column_idx);
   // the third parameter "is_inlined" is unused
   return Value::DeserializeFrom(data_ptr, column_type);
 }
 
 auto Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs)
-    -> Tuple {
+    const -> Tuple {
   std::vector<Value> values;
   values.reserve(key_attrs.size());
   for (auto idx : key_attrs) {
@@ -129,6 +146,18 @@ auto Tuple::GetDataPtr(const Schema *schema, const uint32_t column_idx) const ->
   return (data_ + offset);
 }
 
+auto Tuple::GetOverflowPointer(const Schema *schema, uint32_t column_idx, OverflowPointer *pointer) const -> bool {
+  if (schema->GetColumn(column_idx).IsInlined()) {
+    return false;
+  }
+  const char *data_ptr = GetDataPtr(schema, column_idx);
+  if (*reinterpret_cast<const uint32_t *>(data_ptr) != BUSTUB_VALUE_OVERFLOW) {
+    return false;
+  }
+  memcpy(pointer, data_ptr + sizeof(uint32_t), sizeof(OverflowPointer));
+  return true;
+}
+
 auto Tuple::ToString(const Schema *schema) const -> std::string {
   std::stringstream os;
 
@@ -162,13 +191,20 @@ void Tuple::SerializeTo(char *storage) const {
 void Tuple::DeserializeFrom(const char *storage) {
   uint32_t size = *reinterpret_cast<const uint32_t *>(storage);
   // Construct a tuple.
-  this->size_ = size;
-  if (this->allocated_) {
-    delete[] this->data_;
+  CopyData(storage + sizeof(int32_t), size);
+}
+
+void Tuple::CopyData(const char *data, uint32_t size) {
+  if (!allocated_ || capacity_ < size) {
+    if (allocated_) {
+      delete[] data_;
+    }
+    data_ = new char[size];
+    capacity_ = size;
+    allocated_ = true;
   }
-  this->data_ = new char[this->size_];
-  memcpy(this->data_, storage + sizeof(int32_t), this->size_);
-  this->allocated_ = true;
+  size_ = size;
+  memcpy(data_, data, size);
 }
 
 }  // namespace bustub
@@ -0,0 +1,31 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_view.cpp
+//
+// Identification: src/storage/table/tuple_view.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/tuple_view.h"
+
+namespace bustub {
+
+auto TupleView::Materialize() const -> Tuple {
+  Tuple tuple(tuple_.rid_);
+  if (tuple_.data_ != nullptr) {
+    tuple.CopyData(tuple_.data_, tuple_.size_);
+  }
+  tuple.overflow_store_ = tuple_.overflow_store_;
+  return tuple;
+}
+
+void TupleView::Release() {
+  tuple_ = Tuple();
+  guard_.reset();
+}
+
+}  // namespace bustub
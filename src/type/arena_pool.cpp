@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena_pool.cpp
+//
+// Identification: src/type/arena_pool.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "type/arena_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace bustub {
+
+auto ArenaPool::Allocate(size_t size) -> void * {
+  constexpr size_t alignment = alignof(std::max_align_t);
+  size = std::max<size_t>((size + alignment - 1) & ~(alignment - 1), alignment);
+  bytes_allocated_ += size;
+  if (size > remaining_) {
+    // Allocations larger than a quarter block get their own block, so they do not waste the rest of the current one.
+    if (size > next_block_size_ / 4) {
+      return AllocateBlock(size);
+    }
+    cur_ = AllocateBlock(next_block_size_);
+    cur_block_ = blocks_.size() - 1;
+    cur_block_size_ = next_block_size_;
+    remaining_ = next_block_size_;
+    next_block_size_ = std::min(next_block_size_ * 2, MAX_BLOCK_SIZE);
+  }
+  auto *ptr = cur_;
+  cur_ += size;
+  remaining_ -= size;
+  return ptr;
+}
+
+void ArenaPool::Reset() {
+  bytes_allocated_ = 0;
+  if (cur_ == nullptr) {
+    blocks_.clear();
+    bytes_reserved_ = 0;
+    return;
+  }
+  // Keep the current block, the largest regular one, and drop the others.
+  std::swap(blocks_.front(), blocks_[cur_block_]);
+  blocks_.resize(1);
+  cur_block_ = 0;
+  cur_ = blocks_.front().get();
+  remaining_ = cur_block_size_;
+  bytes_reserved_ = cur_block_size_;
+}
+
+auto ArenaPool::AllocateBlock(size_t size) -> char * {
+  // Not std::make_unique, which would zero the block.
+  blocks_.emplace_back(new char[size]);
+  bytes_reserved_ += size;
+  return blocks_.back().get();
+}
+
+}  // namespace bustub
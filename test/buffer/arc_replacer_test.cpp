@@ -0,0 +1,61 @@
+/**
+ * arc_replacer_test.cpp
+ */
+
+#include "buffer/arc_replacer.h"
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(ARCReplacerTest, SampleTest) {
+  ARCReplacer arc_replacer(4);
+
+  // Scenario: load pages 10-13 into frames 0-3 and touch page 10 again. T1 = [1,2,3], T2 = [0].
+  for (frame_id_t fid = 0; fid < 4; fid++) {
+    arc_replacer.RecordAccess(fid, AccessType::Get, 10 + fid);
+    arc_replacer.SetEvictable(fid, true);
+  }
+  arc_replacer.RecordAccess(0, AccessType::Get, 10);
+  ASSERT_EQ(4, arc_replacer.Size());
+  ASSERT_EQ(0, arc_replacer.GetTargetT1Size());
+
+  // Scenario: T1 is above its target size, so its LRU frame goes first. Page 11 is remembered in B1.
+  frame_id_t value;
+  ASSERT_TRUE(arc_replacer.Evict(&value));
+  ASSERT_EQ(1, value);
+
+  // Scenario: page 11 comes back. The B1 hit grows the target size of T1 and the page goes straight to T2.
+  arc_replacer.RecordAccess(1, AccessType::Get, 11);
+  arc_replacer.SetEvictable(1, true);
+  ASSERT_EQ(1, arc_replacer.GetTargetT1Size());
+
+  // Scenario: T1 = [2,3] is larger than 1, then it is not, so the LRU frame of T2 = [0,1] goes next.
+  ASSERT_TRUE(arc_replacer.Evict(&value));
+  ASSERT_EQ(2, value);
+  ASSERT_TRUE(arc_replacer.Evict(&value));
+  ASSERT_EQ(0, value);
+
+  // Scenario: page 10 comes back. The B2 hit shrinks the target size of T1 again.
+  arc_replacer.RecordAccess(0, AccessType::Get, 10);
+  arc_replacer.SetEvictable(0, true);
+  ASSERT_EQ(0, arc_replacer.GetTargetT1Size());
+
+  // Scenario: a page touched repeatedly by a scan stays in T1 and is evicted before T2 = [1,0].
+  arc_replacer.RecordAccess(2, AccessType::Scan, 20);
+  arc_replacer.RecordAccess(2, AccessType::Scan, 20);
+  arc_replacer.SetEvictable(2, true);
+  ASSERT_TRUE(arc_replacer.Evict(&value));
+  ASSERT_EQ(3, value);
+  ASSERT_TRUE(arc_replacer.Evict(&value));
+  ASSERT_EQ(2, value);
+
+  // Scenario: pinned frames are never evicted, removed frames are forgotten.
+  arc_replacer.SetEvictable(1, false);
+  ASSERT_EQ(1, arc_replacer.Size());
+  arc_replacer.Remove(0);
+  ASSERT_EQ(0, arc_replacer.Size());
+  ASSERT_FALSE(arc_replacer.Evict(&value));
+}
+
+}  // namespace bustub
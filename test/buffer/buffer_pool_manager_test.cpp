@@ -12,18 +12,49 @@
 
 #include "buffer/buffer_pool_manager.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <cstdio>
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
+#include <unordered_set>
+#include <vector>
 
 #include "gtest/gtest.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager_memory.h"
 
 namespace bustub {
 
+class BufferPoolManagerTest : public ::testing::Test {
+ protected:
+  // Every test gets its own database file, so that the tests can run in parallel with others.
+  void SetUp() override {
+    file_base_ =
+        std::string("buffer_pool_manager_test_") + ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    RemoveFiles();
+  }
+
+  void TearDown() override { RemoveFiles(); }
+
+  /** @return the name of the database file of the test */
+  auto DbName() const -> std::string { return file_base_ + ".db"; }
+
+  void RemoveFiles() const {
+    for (const auto *extension : {".db", ".log", ".fpm"}) {
+      remove((file_base_ + extension).c_str());
+    }
+  }
+
+  std::string file_base_;
+};
+
 // NOLINTNEXTLINE
 // Check whether pages containing terminal characters can be recovered
-TEST(BufferPoolManagerTest, DISABLED_BinaryDataTest) {
-  const std::string db_name = "test.db";
+TEST_F(BufferPoolManagerTest, BinaryDataTest) {
+  const std::string db_name = DbName();
   const size_t buffer_pool_size = 10;
   const size_t k = 5;
 
@@ -79,17 +110,16 @@ TEST(BufferPoolManagerTest, DISABLED_BinaryDataTest) {
   EXPECT_EQ(0, memcmp(page0->GetData(), random_binary_data, BUSTUB_PAGE_SIZE));
   EXPECT_EQ(true, bpm->UnpinPage(0, true));
 
-  // Shutdown the disk manager and remove the temporary file we created.
+  // Shutdown the disk manager; the fixture removes the temporary files we created.
   disk_manager->ShutDown();
-  remove("test.db");
 
   delete bpm;
   delete disk_manager;
 }
 
 // NOLINTNEXTLINE
-TEST(BufferPoolManagerTest, DISABLED_SampleTest) {
-  const std::string db_name = "test.db";
+TEST_F(BufferPoolManagerTest, SampleTest) {
+  const std::string db_name = DbName();
   const size_t buffer_pool_size = 10;
   const size_t k = 5;
 
@@ -136,12 +166,725 @@ TEST(BufferPoolManagerTest, DISABLED_SampleTest) {
   EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
   EXPECT_EQ(nullptr, bpm->FetchPage(0));
 
-  // Shutdown the disk manager and remove the temporary file we created.
+  // Shutdown the disk manager; the fixture removes the temporary files we created.
   disk_manager->ShutDown();
-  remove("test.db");
 
   delete bpm;
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, ParallelInstancesTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t num_instances = 4;
+  const size_t k = 5;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k, nullptr, num_instances);
+  ASSERT_EQ(num_instances, bpm->GetNumInstances());
+
+  // Scenario: every frame of every instance can hold a new page, and page ids are never handed out twice.
+  std::unordered_set<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    ASSERT_EQ(page_id, page->GetPageId());
+    ASSERT_TRUE(page_ids.insert(page_id).second);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+  }
+
+  // Scenario: once all frames are pinned, no instance can create a new page.
+  page_id_t page_id_temp;
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+
+  // Scenario: unpinned pages are written back on eviction and can be read again from any instance.
+  for (auto page_id : page_ids) {
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  }
+  for (auto page_id : page_ids) {
+    auto guard = bpm->FetchPageRead(page_id);
+    EXPECT_EQ(0, strcmp(guard.GetData(), ("page " + std::to_string(page_id)).c_str()));
+  }
+
+  // Scenario: concurrent readers and writers on disjoint pages keep the pin counts balanced.
+  std::vector<std::thread> threads;
+  std::vector<page_id_t> ids(page_ids.begin(), page_ids.end());
+  for (size_t t = 0; t < num_instances; ++t) {
+    threads.emplace_back([&bpm, &ids, t] {
+      for (size_t round = 0; round < 100; ++round) {
+        auto page_id = ids[(t + round) % ids.size()];
+        auto guard = bpm->FetchPageWrite(page_id);
+        ASSERT_EQ(page_id, guard.PageId());
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (auto page_id : page_ids) {
+    EXPECT_TRUE(bpm->DeletePage(page_id));
+  }
+}
+
+/** An in-memory disk manager that counts page reads and writes. */
+class CountingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    num_reads_++;
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+  void WritePage(page_id_t page_id, const char *page_data) override {
+    num_writes_++;
+    DiskManagerUnlimitedMemory::WritePage(page_id, page_data);
+  }
+
+  void WritePages(page_id_t page_id, const std::vector<const char *> &pages) override {
+    num_vectored_writes_++;
+    DiskManagerUnlimitedMemory::WritePages(page_id, pages);
+  }
+
+  std::atomic<size_t> num_reads_{0};
+  /** Pages written, whether alone or as part of a vectored write. */
+  std::atomic<size_t> num_writes_{0};
+  std::atomic<size_t> num_vectored_writes_{0};
+};
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, FlushAllPagesTest) {
+  const size_t buffer_pool_size = 16;
+  const size_t num_pages = 8;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k, nullptr, 2);
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < num_pages; ++i) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+  std::sort(page_ids.begin(), page_ids.end());
+  ASSERT_EQ(0, page_ids.front());
+  ASSERT_EQ(static_cast<page_id_t>(num_pages - 1), page_ids.back());
+
+  // Scenario: consecutive dirty pages of all instances go out in a single vectored write.
+  bpm->FlushAllPages();
+  EXPECT_EQ(num_pages, disk_manager->num_writes_.load());
+  EXPECT_EQ(1, disk_manager->num_vectored_writes_.load());
+
+  // Scenario: only the dirty pages are written, one write per run of consecutive page ids.
+  for (page_id_t page_id : {2, 3, 6}) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  ASSERT_NE(nullptr, bpm->FetchPage(4));
+  ASSERT_TRUE(bpm->UnpinPage(4, false));
+  bpm->FlushAllPages();
+  EXPECT_EQ(num_pages + 3, disk_manager->num_writes_.load());
+  EXPECT_EQ(2, disk_manager->num_vectored_writes_.load());
+
+  // Scenario: a clean pool writes nothing.
+  bpm->FlushAllPages();
+  EXPECT_EQ(num_pages + 3, disk_manager->num_writes_.load());
+}
+
+/** Pages of the read-ahead test keep the id of the next page of their chain at this offset. */
+static constexpr size_t NEXT_PAGE_ID_OFFSET = 16;
+
+static auto NextPageIdOf(const char *page_data) -> page_id_t {
+  page_id_t next_page_id;
+  memcpy(&next_page_id, page_data + NEXT_PAGE_ID_OFFSET, sizeof(page_id_t));
+  return next_page_id;
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, ReadAheadTest) {
+  const size_t buffer_pool_size = 16;
+  const size_t num_pages = 32;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<CountingDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k, nullptr, 1);
+
+  // Scenario: read-ahead is off unless enabled, and the window is limited to the frames an instance lets prefetched
+  // pages occupy.
+  EXPECT_EQ(0, bpm->GetReadAheadWindow());
+  bpm->SetReadAheadWindow(8);
+  EXPECT_EQ(buffer_pool_size / 4, bpm->GetReadAheadWindow());
+  bpm->SetReadAheadWindow(0);
+  EXPECT_EQ(0, bpm->GetReadAheadWindow());
+
+  // The pages form a chain from the highest page id down to 0, so following page ids upwards would read the wrong
+  // pages.
+  for (size_t i = 0; i < num_pages; ++i) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), NEXT_PAGE_ID_OFFSET, "page %d", page_id);
+    const page_id_t next_page_id = page_id == 0 ? INVALID_PAGE_ID : page_id - 1;
+    memcpy(page->GetData() + NEXT_PAGE_ID_OFFSET, &next_page_id, sizeof(page_id_t));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  // Push every page of the chain out of the pool.
+  std::vector<page_id_t> fillers(buffer_pool_size);
+  for (auto &page_id : fillers) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+  for (auto page_id : fillers) {
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+    ASSERT_TRUE(bpm->DeletePage(page_id));
+  }
+  bpm->SetReadAheadWindow(8);
+  const size_t window = bpm->GetReadAheadWindow();
+  disk_manager->num_reads_ = 0;
+
+  // Scenario: a scan fetch without a hint does not read ahead.
+  const auto first = static_cast<page_id_t>(num_pages - 1);
+  ASSERT_NE(nullptr, bpm->FetchPage(first, AccessType::Scan));
+  EXPECT_EQ(1, disk_manager->num_reads_.load());
+
+  // Scenario: the hint of the scan's first page reads the following pages of the chain in the background.
+  bpm->ReadAheadHint(first, first - 1, NextPageIdOf);
+  bpm->ReadAheadHint(first, first - 1, NextPageIdOf);
+  ASSERT_TRUE(bpm->UnpinPage(first, false));
+  for (int i = 0; i < 1000 && disk_manager->num_reads_ < 1 + window; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(1 + window, disk_manager->num_reads_.load());
+  for (page_id_t page_id = first - 1; page_id > first - 1 - static_cast<page_id_t>(window); --page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), ("page " + std::to_string(page_id)).c_str()));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(1 + window, disk_manager->num_reads_.load());
+
+  // Scenario: the rest of the scan sees the right data, every page is read once, and prefetched pages never stay
+  // pinned.
+  for (page_id_t page_id = first - 1 - static_cast<page_id_t>(window); page_id != INVALID_PAGE_ID;) {
+    auto *page = bpm->FetchPage(page_id, AccessType::Scan);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), ("page " + std::to_string(page_id)).c_str()));
+    const page_id_t next_page_id = NextPageIdOf(page->GetData());
+    bpm->ReadAheadHint(page_id, next_page_id, NextPageIdOf);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+    page_id = next_page_id;
+  }
+  EXPECT_EQ(num_pages, disk_manager->num_reads_.load());
+  std::vector<page_id_t> pinned;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    pinned.push_back(page_id);
+  }
+  for (auto page_id : pinned) {
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+}
+
+/** An in-memory disk manager whose page reads and vectored writes take a while. */
+class SlowDiskManager : public CountingDiskManager {
+ public:
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    CountingDiskManager::ReadPage(page_id, page_data);
+    std::this_thread::sleep_for(std::chrono::milliseconds(read_delay_ms_.load()));
+  }
+
+  void WritePages(page_id_t page_id, const std::vector<const char *> &pages) override {
+    CountingDiskManager::WritePages(page_id, pages);
+    std::this_thread::sleep_for(std::chrono::milliseconds(write_delay_ms_.load()));
+  }
+
+  std::atomic<int> read_delay_ms_{0};
+  std::atomic<int> write_delay_ms_{0};
+};
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, ConcurrentIOTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t num_pages = 8;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<SlowDiskManager>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k, nullptr, 1);
+  for (size_t i = 0; i < num_pages; ++i) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  const page_id_t cached_page_id = num_pages - 1;
+  disk_manager->read_delay_ms_ = 300;
+
+  // Scenario: a slow read does not hold up fetching a page that is already cached.
+  std::thread first([&] {
+    auto *page = bpm->FetchPage(0);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), "page 0"));
+  });
+  while (disk_manager->num_reads_ == 0) {
+    std::this_thread::yield();
+  }
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_NE(nullptr, bpm->FetchPage(cached_page_id));
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(150));
+  ASSERT_TRUE(bpm->UnpinPage(cached_page_id, false));
+
+  // Scenario: a fetch of a page that is being read in waits for that read instead of reading the page again.
+  std::thread second([&] {
+    auto *page = bpm->FetchPage(0);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), "page 0"));
+  });
+  first.join();
+  second.join();
+  EXPECT_EQ(1, disk_manager->num_reads_.load());
+  EXPECT_EQ(3, bpm->FetchPage(0)->GetPinCount());
+  ASSERT_TRUE(bpm->UnpinPage(0, false));
+  ASSERT_TRUE(bpm->UnpinPage(0, false));
+  ASSERT_TRUE(bpm->UnpinPage(0, false));
+
+  // Scenario: FlushAllPages does not hold the latch while it writes, so a cached page can be fetched meanwhile.
+  disk_manager->read_delay_ms_ = 0;
+  disk_manager->write_delay_ms_ = 300;
+  for (page_id_t page_id : {0, 1}) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  const size_t vectored_writes = disk_manager->num_vectored_writes_;
+  std::thread flush_thread([&] { bpm->FlushAllPages(); });
+  while (disk_manager->num_vectored_writes_ == vectored_writes) {
+    std::this_thread::yield();
+  }
+  start = std::chrono::steady_clock::now();
+  auto *page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(150));
+  EXPECT_EQ(0, strcmp(page->GetData(), "page 0"));
+  ASSERT_TRUE(bpm->UnpinPage(0, false));
+  flush_thread.join();
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, ScanRingTest) {
+  const size_t buffer_pool_size = 16;
+  const size_t num_hot_pages = 8;
+  const size_t num_pages = 64;
+  const size_t k = 2;
+
+  // Run a scan that reads every page twice, the way TableIterator does, and count the reads of hot pages after it.
+  auto hot_page_misses_after_scan = [&](size_t scan_ring_size) {
+    auto disk_manager = std::make_unique<CountingDiskManager>();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k, nullptr, 1);
+    bpm->SetScanRingSize(scan_ring_size);
+    EXPECT_EQ(scan_ring_size, bpm->GetScanRingSize());
+
+    for (size_t i = 0; i < num_pages; ++i) {
+      page_id_t page_id;
+      EXPECT_NE(nullptr, bpm->NewPage(&page_id));
+      snprintf(bpm->FetchPage(page_id)->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+      EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+      EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+    for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_hot_pages); ++page_id) {
+      for (size_t access = 0; access < k; ++access) {
+        EXPECT_NE(nullptr, bpm->FetchPage(page_id, AccessType::Get));
+        EXPECT_TRUE(bpm->UnpinPage(page_id, false, AccessType::Get));
+      }
+    }
+    for (auto page_id = static_cast<page_id_t>(num_hot_pages); page_id < static_cast<page_id_t>(num_pages);
+         ++page_id) {
+      for (int tuple = 0; tuple < 2; ++tuple) {
+        auto *page = bpm->FetchPage(page_id, AccessType::Scan);
+        EXPECT_NE(nullptr, page);
+        EXPECT_EQ(0, strcmp(page->GetData(), ("page " + std::to_string(page_id)).c_str()));
+        EXPECT_TRUE(bpm->UnpinPage(page_id, false, AccessType::Scan));
+      }
+    }
+
+    const size_t reads_before = disk_manager->num_reads_;
+    for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(num_hot_pages); ++page_id) {
+      EXPECT_NE(nullptr, bpm->FetchPage(page_id, AccessType::Get));
+      EXPECT_TRUE(bpm->UnpinPage(page_id, false, AccessType::Get));
+    }
+    return disk_manager->num_reads_ - reads_before;
+  };
+
+  // Scenario: without a ring, the scan pages look as hot as the working set and push it out of the pool.
+  EXPECT_EQ(num_hot_pages, hot_page_misses_after_scan(0));
+  // Scenario: with a ring, the scan recycles its own frames and every hot page is still cached.
+  EXPECT_EQ(0, hot_page_misses_after_scan(4));
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, PageCleanerTest) {
+  const size_t buffer_pool_size = 8;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto log_manager = std::make_unique<LogManager>(disk_manager.get());
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k, log_manager.get(), 1);
+
+  auto fill_with_dirty_pages = [&] {
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      page_id_t page_id;
+      auto *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      page->SetLSN(page_id);
+      ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+  };
+
+  // Scenario: a pass only writes back enough pages to reach the target share of clean frames.
+  fill_with_dirty_pages();
+  EXPECT_EQ(buffer_pool_size / 2, bpm->CleanFrames(50));
+  EXPECT_EQ(0, bpm->CleanFrames(50));
+  EXPECT_EQ(buffer_pool_size / 2, bpm->CleanFrames(100));
+  EXPECT_EQ(buffer_pool_size, bpm->GetCleanerWriteBacks());
+
+  // Scenario: the victims are already clean, so NewPage does not write anything back itself.
+  fill_with_dirty_pages();
+  EXPECT_EQ(0, bpm->GetForegroundWriteBacks());
+
+  // Scenario: pages whose log records are not persistent yet stay dirty.
+  enable_logging = true;
+  log_manager->SetPersistentLSN(static_cast<lsn_t>(buffer_pool_size + buffer_pool_size / 2 - 1));
+  EXPECT_EQ(buffer_pool_size / 2, bpm->CleanFrames(100));
+  log_manager->SetPersistentLSN(static_cast<lsn_t>(2 * buffer_pool_size));
+  EXPECT_EQ(buffer_pool_size / 2, bpm->CleanFrames(100));
+  enable_logging = false;
+
+  // Scenario: the background cleaner keeps the pool clean while pages are written.
+  bpm->StartPageCleaner(100);
+  fill_with_dirty_pages();
+  for (int i = 0; i < 1000 && bpm->GetCleanerWriteBacks() < 3 * buffer_pool_size; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  bpm->StopPageCleaner();
+  EXPECT_EQ(3 * buffer_pool_size, bpm->GetCleanerWriteBacks());
+  EXPECT_EQ(0, bpm->GetForegroundWriteBacks());
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, FrameArenaTest) {
+  const size_t buffer_pool_size = 1 << 16;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2, nullptr, 4);
+
+  // Scenario: the frame data is one contiguous arena that starts on a huge page boundary, and the metadata is
+  // cache-line aligned.
+  auto *pages = bpm->GetPages();
+  auto *arena = pages[0].GetData();
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(arena) % BUSTUB_HUGE_PAGE_SIZE);
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_EQ(arena + i * BUSTUB_PAGE_SIZE, pages[i].GetData());
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(&pages[i]) % BUSTUB_CACHE_LINE_SIZE);
+  }
+
+  // Scenario: frames start out zeroed and keep their data until evicted.
+  page_id_t page_id;
+  auto *page = bpm->NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, page->GetData()[BUSTUB_PAGE_SIZE - 1]);
+  page->GetData()[BUSTUB_PAGE_SIZE - 1] = 'x';
+  ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  page = bpm->FetchPage(page_id);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ('x', page->GetData()[BUSTUB_PAGE_SIZE - 1]);
+  ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, ReplacerTypesTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t num_pages = 50;
+
+  for (auto replacer_type : {ReplacerType::LRUK, ReplacerType::LRU, ReplacerType::Clock, ReplacerType::ARC,
+                             ReplacerType::TwoQueue}) {
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2, nullptr, 1, replacer_type);
+
+    // Scenario: more pages than frames go through the pool and keep their content.
+    std::vector<page_id_t> page_ids;
+    for (size_t i = 0; i < num_pages; ++i) {
+      page_id_t page_id;
+      auto *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+      ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+      page_ids.push_back(page_id);
+    }
+    for (int round = 0; round < 2; ++round) {
+      for (auto page_id : page_ids) {
+        auto *page = bpm->FetchPage(page_id, AccessType::Get);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+        ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+    }
+
+    // Scenario: pinned pages are never evicted.
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+    }
+    page_id_t page_id;
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      ASSERT_TRUE(bpm->UnpinPage(page_ids[i], false));
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, StatsTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k, nullptr, 1);
+
+  // Scenario: fill the pool with dirty pages; creating pages is neither a hit nor a miss.
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size * 2; ++i) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+  auto stats = bpm->GetStats();
+  EXPECT_EQ(0, stats.hits_ + stats.misses_);
+  EXPECT_EQ(buffer_pool_size, stats.evictions_);
+  EXPECT_EQ(buffer_pool_size, stats.dirty_write_backs_);
+
+  // Scenario: the last pages are cached, the first ones have to be read again.
+  for (auto it = page_ids.rbegin(); it != page_ids.rend(); ++it) {
+    ASSERT_NE(nullptr, bpm->FetchPage(*it));
+    ASSERT_TRUE(bpm->UnpinPage(*it, false));
+  }
+  stats = bpm->GetStats();
+  EXPECT_EQ(buffer_pool_size, stats.misses_);
+  EXPECT_EQ(buffer_pool_size, stats.hits_);
+  EXPECT_DOUBLE_EQ(0.5, stats.HitRatio());
+
+  // Scenario: a request that finds every frame pinned counts as a pin wait.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_ids[i]));
+  }
+  page_id_t page_id;
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+  stats = bpm->GetStats();
+  EXPECT_EQ(1, stats.pin_waits_);
+
+  // Every latch acquisition shows up in both histograms.
+  auto acquisitions = BufferPoolStatsSnapshot::Count(stats.latch_wait_ns_);
+  EXPECT_GT(acquisitions, 0);
+  EXPECT_EQ(acquisitions, BufferPoolStatsSnapshot::Count(stats.latch_hold_ns_));
+  EXPECT_LE(BufferPoolStatsSnapshot::Percentile(stats.latch_hold_ns_, 50),
+            BufferPoolStatsSnapshot::Percentile(stats.latch_hold_ns_, 99));
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, ResizePoolTest) {
+  const size_t buffer_pool_size = 8;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), k, nullptr, 2);
+
+  auto new_pinned_page = [&](std::vector<page_id_t> *page_ids) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    if (page != nullptr) {
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+      page_ids->push_back(page_id);
+    }
+    return page;
+  };
+
+  // Scenario: growing adds frames while the existing pages stay pinned in place.
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, new_pinned_page(&page_ids));
+  }
+  EXPECT_EQ(nullptr, new_pinned_page(&page_ids));
+  ASSERT_TRUE(bpm->ResizePool(4 * buffer_pool_size));
+  EXPECT_EQ(4 * buffer_pool_size, bpm->GetPoolSize());
+  for (size_t i = buffer_pool_size; i < 4 * buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, new_pinned_page(&page_ids));
+  }
+  EXPECT_EQ(nullptr, new_pinned_page(&page_ids));
+  for (auto page_id : page_ids) {
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: shrinking waits for a pinned page beyond the new size and writes back the dirty pages.
+  auto *pinned = bpm->FetchPage(page_ids.back());
+  ASSERT_NE(nullptr, pinned);
+  std::thread unpin_thread([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    pinned->GetData()[BUSTUB_PAGE_SIZE - 1] = 'x';
+    bpm->UnpinPage(page_ids.back(), true);
+  });
+  ASSERT_TRUE(bpm->ResizePool(buffer_pool_size / 2));
+  unpin_thread.join();
+  EXPECT_EQ(buffer_pool_size / 2, bpm->GetPoolSize());
+
+  for (auto page_id : page_ids) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  auto *page = bpm->FetchPage(page_ids.back());
+  EXPECT_EQ('x', page->GetData()[BUSTUB_PAGE_SIZE - 1]);
+  ASSERT_TRUE(bpm->UnpinPage(page_ids.back(), false));
+
+  // Scenario: a shrink gives up when a pinned page is not unpinned in time, and the pool keeps its size.
+  const size_t small_pool_size = buffer_pool_size / 2;
+  std::vector<page_id_t> small_page_ids;
+  for (size_t i = 0; i < small_pool_size; ++i) {
+    ASSERT_NE(nullptr, new_pinned_page(&small_page_ids));
+  }
+  EXPECT_FALSE(bpm->ResizePool(2, std::chrono::milliseconds(50)));
+  EXPECT_EQ(small_pool_size, bpm->GetPoolSize());
+  EXPECT_EQ(nullptr, new_pinned_page(&small_page_ids));
+  for (auto page_id : small_page_ids) {
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: fetching a page whose frame a shrink is waiting for moves it to a live frame once it is unpinned, so
+  // the shrink completes even though the page is pinned again.
+  page_id_t retiring_page_id = INVALID_PAGE_ID;
+  for (auto page_id : small_page_ids) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    if (page - bpm->GetPages() >= 2) {
+      retiring_page_id = page_id;
+      break;
+    }
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  ASSERT_NE(INVALID_PAGE_ID, retiring_page_id);
+  std::thread shrink_thread([&] { EXPECT_TRUE(bpm->ResizePool(2)); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  std::thread refetch_thread([&] {
+    auto *page = bpm->FetchPage(retiring_page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_LT(page - bpm->GetPages(), 2);
+    EXPECT_EQ("page " + std::to_string(retiring_page_id), std::string(page->GetData()));
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  ASSERT_TRUE(bpm->UnpinPage(retiring_page_id, false));
+  refetch_thread.join();
+  shrink_thread.join();
+  EXPECT_EQ(2, bpm->GetPoolSize());
+  ASSERT_TRUE(bpm->UnpinPage(retiring_page_id, false));
+
+  // Scenario: a shrink caps the read-ahead window and scan ring, and growing back restores the configured ones.
+  ASSERT_TRUE(bpm->ResizePool(4 * buffer_pool_size));
+  bpm->SetReadAheadWindow(buffer_pool_size);
+  bpm->SetScanRingSize(buffer_pool_size);
+  EXPECT_EQ(buffer_pool_size, bpm->GetReadAheadWindow());
+  EXPECT_EQ(buffer_pool_size, bpm->GetScanRingSize());
+  ASSERT_TRUE(bpm->ResizePool(buffer_pool_size));
+  EXPECT_EQ(buffer_pool_size / 4, bpm->GetReadAheadWindow());
+  EXPECT_EQ(buffer_pool_size / 4, bpm->GetScanRingSize());
+  ASSERT_TRUE(bpm->ResizePool(4 * buffer_pool_size));
+  EXPECT_EQ(buffer_pool_size, bpm->GetReadAheadWindow());
+  EXPECT_EQ(buffer_pool_size, bpm->GetScanRingSize());
+
+  // Scenario: the pool can't shrink below one frame per instance or grow past the reservation.
+  EXPECT_FALSE(bpm->ResizePool(1));
+  EXPECT_FALSE(bpm->ResizePool(bpm->GetMaxPoolSize() + 1));
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, PageSizeTest) {
+  const size_t buffer_pool_size = 4;
+  const size_t page_size = 65536;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>(page_size);
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2, nullptr, 2);
+  EXPECT_EQ(page_size, bpm->GetPageSize());
+
+  // Scenario: every frame spans a whole page of the disk manager's page size.
+  auto *pages = bpm->GetPages();
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_EQ(pages[0].GetData() + i * page_size, pages[i].GetData());
+    ASSERT_EQ(page_size, pages[i].GetPageSize());
+  }
+
+  // Scenario: pages survive eviction byte for byte, including their last byte.
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < 4 * buffer_pool_size; ++i) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), page_size, "page %d", page_id);
+    page->GetData()[page_size - 1] = static_cast<char>('a' + i);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    auto *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_ids[i]), std::string(page->GetData()));
+    EXPECT_EQ(static_cast<char>('a' + i), page->GetData()[page_size - 1]);
+    ASSERT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(BufferPoolManagerTest, DeallocatePageTest) {
+  const size_t buffer_pool_size = 8;
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager.get(), 2, nullptr, 1);
+
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < 4 * buffer_pool_size; ++i) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+
+  // Scenario: deleted pages, cached or not, are handed out again lowest first before any new page id.
+  ASSERT_TRUE(bpm->DeletePage(page_ids[3]));
+  ASSERT_TRUE(bpm->DeletePage(page_ids[1]));
+  ASSERT_TRUE(bpm->DeletePage(page_ids.back()));
+  EXPECT_EQ(3, disk_manager->GetNumFreePages());
+  std::vector<page_id_t> reused;
+  for (size_t i = 0; i < 3; ++i) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, page->GetData()[0]);
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+    reused.push_back(page_id);
+  }
+  EXPECT_EQ((std::vector<page_id_t>{page_ids[1], page_ids[3], page_ids.back()}), reused);
+  EXPECT_EQ(0, disk_manager->GetNumFreePages());
+
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(static_cast<page_id_t>(page_ids.size()), page_id);
+  ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+
+  // Scenario: a pinned page is neither deleted nor deallocated.
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids[0]));
+  EXPECT_FALSE(bpm->DeletePage(page_ids[0]));
+  EXPECT_EQ(0, disk_manager->GetNumFreePages());
+  ASSERT_TRUE(bpm->UnpinPage(page_ids[0], false));
+}
+
 }  // namespace bustub
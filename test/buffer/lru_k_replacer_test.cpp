@@ -16,7 +16,7 @@
 
 namespace bustub {
 
-TEST(LRUKReplacerTest, DISABLED_SampleTest) {
+TEST(LRUKReplacerTest, SampleTest) {
   LRUKReplacer lru_replacer(7, 2);
 
   // Scenario: add six elements to the replacer. We have [1,2,3,4,5]. Frame 6 is non-evictable.
@@ -95,4 +95,120 @@ TEST(LRUKReplacerTest, DISABLED_SampleTest) {
   ASSERT_EQ(false, lru_replacer.Evict(&value));
   ASSERT_EQ(0, lru_replacer.Size());
 }
+
+TEST(LRUKReplacerTest, ConcurrentRecordAccessTest) {
+  const size_t num_threads = 8;
+  const size_t frames_per_thread = 64;
+  LRUKReplacer lru_replacer(num_threads * frames_per_thread, 2);
+
+  // Every thread owns a range of frames. Frames divisible by 4 are accessed once, all others many times.
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back([&lru_replacer, t] {
+      for (size_t round = 0; round < 100; round++) {
+        for (size_t i = 0; i < frames_per_thread; i++) {
+          auto frame_id = static_cast<frame_id_t>(t * frames_per_thread + i);
+          if (round == 0 || frame_id % 4 != 0) {
+            lru_replacer.RecordAccess(frame_id);
+          }
+          lru_replacer.SetEvictable(frame_id, round % 2 == 1);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(num_threads * frames_per_thread, lru_replacer.Size());
+
+  // Frames with +inf backward k-distance go first, then every other frame exactly once.
+  std::set<frame_id_t> evicted;
+  frame_id_t value;
+  for (size_t i = 0; i < num_threads * frames_per_thread; i++) {
+    ASSERT_TRUE(lru_replacer.Evict(&value));
+    ASSERT_EQ(i < num_threads * frames_per_thread / 4, value % 4 == 0);
+    ASSERT_TRUE(evicted.insert(value).second);
+  }
+  ASSERT_FALSE(lru_replacer.Evict(&value));
+  ASSERT_EQ(0, lru_replacer.Size());
+}
+
+TEST(LRUKReplacerTest, RecordHitTest) {
+  LRUKReplacer lru_replacer(7, 2);
+  frame_id_t value;
+
+  // Scenario: frames [1,2,3,4] are loaded, then hit by different threads while pinned. The hits are collected in
+  // buffers, but Evict sees them: frame 4 has +inf backward k-distance, frame 1 was hit last.
+  for (frame_id_t fid = 1; fid <= 4; fid++) {
+    lru_replacer.RecordAccess(fid);
+  }
+  std::thread hit_1([&] {
+    lru_replacer.RecordHit(1);
+    lru_replacer.RecordHit(1);
+  });
+  hit_1.join();
+  std::thread hit_2([&] { lru_replacer.RecordHit(2); });
+  hit_2.join();
+  lru_replacer.RecordHit(3);
+  for (frame_id_t fid = 1; fid <= 4; fid++) {
+    lru_replacer.SetEvictable(fid, true);
+  }
+  for (frame_id_t expected : {4, 2, 3, 1}) {
+    ASSERT_TRUE(lru_replacer.Evict(&value));
+    ASSERT_EQ(expected, value);
+  }
+
+  // Scenario: a hit collected before a frame was removed does not count for the next page in the frame. Both frames
+  // have +inf backward k-distance then, and frame 5 was loaded first.
+  lru_replacer.RecordAccess(5);
+  lru_replacer.RecordHit(5);
+  lru_replacer.SetEvictable(5, true);
+  lru_replacer.Remove(5);
+  lru_replacer.RecordAccess(5);
+  lru_replacer.RecordAccess(6);
+  lru_replacer.SetEvictable(5, true);
+  lru_replacer.SetEvictable(6, true);
+  ASSERT_TRUE(lru_replacer.Evict(&value));
+  ASSERT_EQ(5, value);
+}
+
+TEST(LRUKReplacerTest, ConcurrentRecordHitTest) {
+  const size_t num_threads = 8;
+  const size_t frames_per_thread = 64;
+  LRUKReplacer lru_replacer(num_threads * frames_per_thread, 2);
+  for (size_t i = 0; i < num_threads * frames_per_thread; i++) {
+    lru_replacer.RecordAccess(static_cast<frame_id_t>(i));
+  }
+
+  // Every thread hits a range of frames, many more times than fit a buffer. Frames divisible by 4 are never hit.
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back([&lru_replacer, t] {
+      for (size_t round = 0; round < 100; round++) {
+        for (size_t i = 0; i < frames_per_thread; i++) {
+          auto frame_id = static_cast<frame_id_t>(t * frames_per_thread + i);
+          if (frame_id % 4 != 0) {
+            lru_replacer.RecordHit(frame_id);
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (size_t i = 0; i < num_threads * frames_per_thread; i++) {
+    lru_replacer.SetEvictable(static_cast<frame_id_t>(i), true);
+  }
+
+  // Frames with +inf backward k-distance go first, then every other frame exactly once.
+  std::set<frame_id_t> evicted;
+  frame_id_t value;
+  for (size_t i = 0; i < num_threads * frames_per_thread; i++) {
+    ASSERT_TRUE(lru_replacer.Evict(&value));
+    ASSERT_EQ(i < num_threads * frames_per_thread / 4, value % 4 == 0);
+    ASSERT_TRUE(evicted.insert(value).second);
+  }
+  ASSERT_FALSE(lru_replacer.Evict(&value));
+}
 }  // namespace bustub
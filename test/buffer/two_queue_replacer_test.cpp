@@ -0,0 +1,56 @@
+/**
+ * two_queue_replacer_test.cpp
+ */
+
+#include "buffer/two_queue_replacer.h"
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(TwoQueueReplacerTest, SampleTest) {
+  // 8 frames: A1in is preferred for eviction above 2 frames, A1out remembers 4 pages.
+  TwoQueueReplacer two_queue_replacer(8);
+
+  // Scenario: load pages 0-3 into frames 0-3. A repeated access while in A1in does not count. A1in = [0,1,2,3].
+  for (frame_id_t fid = 0; fid < 4; fid++) {
+    two_queue_replacer.RecordAccess(fid, AccessType::Get, fid);
+    two_queue_replacer.SetEvictable(fid, true);
+  }
+  two_queue_replacer.RecordAccess(0, AccessType::Get, 0);
+  ASSERT_EQ(4, two_queue_replacer.Size());
+
+  // Scenario: A1in is evicted in FIFO order; pages 0 and 1 are remembered in A1out.
+  frame_id_t value;
+  ASSERT_TRUE(two_queue_replacer.Evict(&value));
+  ASSERT_EQ(0, value);
+  ASSERT_TRUE(two_queue_replacer.Evict(&value));
+  ASSERT_EQ(1, value);
+
+  // Scenario: page 0 comes back and is hot, page 5 is new. Am = [0], A1in = [2,3,1].
+  two_queue_replacer.RecordAccess(0, AccessType::Get, 0);
+  two_queue_replacer.SetEvictable(0, true);
+  two_queue_replacer.RecordAccess(1, AccessType::Get, 5);
+  two_queue_replacer.SetEvictable(1, true);
+
+  // Scenario: A1in shrinks to its target size first, then Am gives up its LRU frame.
+  ASSERT_TRUE(two_queue_replacer.Evict(&value));
+  ASSERT_EQ(2, value);
+  ASSERT_TRUE(two_queue_replacer.Evict(&value));
+  ASSERT_EQ(0, value);
+
+  // Scenario: with Am empty, A1in is used even below its target size.
+  ASSERT_TRUE(two_queue_replacer.Evict(&value));
+  ASSERT_EQ(3, value);
+
+  // Scenario: pinned frames are never evicted, removed frames are forgotten.
+  two_queue_replacer.SetEvictable(1, false);
+  ASSERT_EQ(0, two_queue_replacer.Size());
+  ASSERT_FALSE(two_queue_replacer.Evict(&value));
+  two_queue_replacer.SetEvictable(1, true);
+  two_queue_replacer.Remove(1);
+  ASSERT_EQ(0, two_queue_replacer.Size());
+  ASSERT_FALSE(two_queue_replacer.Evict(&value));
+}
+
+}  // namespace bustub
@@ -51,6 +51,8 @@ TEST(HashTablePageTest, DISABLED_DirectoryPageSampleTest) {
   bpm->UnpinPage(directory_page_id, true);
   disk_manager->ShutDown();
   remove("test.db");
+  remove("test.log");
+  remove("test.fpm");
   delete disk_manager;
   delete bpm;
 }
@@ -109,6 +111,8 @@ TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
   bpm->UnpinPage(bucket_page_id, true);
   disk_manager->ShutDown();
   remove("test.db");
+  remove("test.log");
+  remove("test.fpm");
   delete disk_manager;
   delete bpm;
 }
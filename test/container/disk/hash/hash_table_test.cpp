@@ -113,6 +113,8 @@ TEST(HashTableTest, DISABLED_SampleTest) {
 
   disk_manager->ShutDown();
   remove("test.db");
+  remove("test.log");
+  remove("test.fpm");
   delete disk_manager;
   delete bpm;
 }
@@ -10,7 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
 
 #include "common/exception.h"
 #include "gtest/gtest.h"
@@ -24,12 +29,14 @@ class DiskManagerTest : public ::testing::Test {
   void SetUp() override {
     remove("test.db");
     remove("test.log");
+    remove("test.fpm");
   }
 
   // This function is called after every test.
   void TearDown() override {
     remove("test.db");
     remove("test.log");
+    remove("test.fpm");
   };
 };
 
@@ -55,6 +62,142 @@ TEST_F(DiskManagerTest, ReadWritePageTest) {
   dm.ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, DirectIOReadWritePageTest) {
+  // One byte past an aligned page buffer, so the disk manager has to go through its bounce buffer.
+  auto *aligned = static_cast<char *>(std::aligned_alloc(BUSTUB_PAGE_ALIGNMENT, 3 * BUSTUB_PAGE_SIZE));
+  char *unaligned = aligned + BUSTUB_PAGE_SIZE + 1;
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file, true);
+
+  std::memset(aligned, 0, 3 * BUSTUB_PAGE_SIZE);
+  std::strncpy(aligned, "An aligned page.", BUSTUB_PAGE_SIZE);
+  std::strncpy(unaligned, "An unaligned page.", BUSTUB_PAGE_SIZE);
+
+  dm.WritePage(0, aligned);
+  dm.WritePage(3, unaligned);
+  dm.ReadPage(0, buf);
+  EXPECT_EQ(std::memcmp(buf, aligned, sizeof(buf)), 0);
+  dm.ReadPage(3, buf);
+  EXPECT_EQ(std::memcmp(buf, unaligned, sizeof(buf)), 0);
+
+  // Pages that were never written read back as zeros.
+  dm.ReadPage(1, aligned);
+  EXPECT_EQ(0, aligned[0]);
+  dm.ReadPage(8, aligned);
+  EXPECT_EQ(0, aligned[0]);
+  EXPECT_EQ(2, dm.GetNumWrites());
+
+  dm.ShutDown();
+  std::free(aligned);
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, WritePagesTest) {
+  const size_t num_pages = 5;
+  std::vector<std::vector<char>> data(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<const char *> pages;
+  for (size_t i = 0; i < num_pages; ++i) {
+    std::fill(data[i].begin(), data[i].end(), static_cast<char>('a' + i));
+    pages.push_back(data[i].data());
+  }
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+
+  dm.WritePages(2, pages);
+  for (size_t i = 0; i < num_pages; ++i) {
+    dm.ReadPage(static_cast<page_id_t>(2 + i), buf);
+    EXPECT_EQ(std::memcmp(buf, data[i].data(), sizeof(buf)), 0);
+  }
+  EXPECT_EQ(num_pages, dm.GetNumWrites());
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, PageSizeTest) {
+  // Its own file, since the other tests running in parallel remove test.db.
+  const std::string db_file = "page_size_test.db";
+  for (size_t page_size : {16384, 65536}) {
+    std::vector<char> data(page_size);
+    std::vector<char> buf(page_size);
+    for (size_t i = 0; i < page_size; i++) {
+      data[i] = static_cast<char>(i % 251);
+    }
+    auto dm = DiskManager(db_file, false, page_size);
+    EXPECT_EQ(page_size, dm.GetPageSize());
+
+    dm.WritePage(0, data.data());
+    dm.WritePage(3, data.data());
+    dm.ReadPage(3, buf.data());
+    EXPECT_EQ(std::memcmp(buf.data(), data.data(), page_size), 0);
+    EXPECT_EQ(4 * page_size, std::filesystem::file_size(db_file));
+    dm.ShutDown();
+
+    // Scenario: the database only opens again with the page size it was created with.
+    EXPECT_THROW(DiskManager(db_file, false, BUSTUB_PAGE_SIZE), Exception);
+    DiskManager(db_file, false, page_size).ShutDown();
+    remove(db_file.c_str());
+  }
+
+  EXPECT_THROW(DiskManager(db_file, false, 2048), Exception);
+  EXPECT_THROW(DiskManager(db_file, false, 12288), Exception);
+  EXPECT_THROW(DiskManager(db_file, false, 2 * BUSTUB_MAX_PAGE_SIZE), Exception);
+  remove("page_size_test.log");
+  remove("page_size_test.fpm");
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, FreePageMapTest) {
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  {
+    auto dm = DiskManager("test.db");
+    EXPECT_EQ(0, dm.GetNumPages());
+    for (page_id_t page_id = 0; page_id < 200; ++page_id) {
+      dm.WritePage(page_id, data);
+    }
+    EXPECT_EQ(INVALID_PAGE_ID, dm.AllocateFreePage());
+
+    // Scenario: deallocated pages are reused lowest first, and only from the requested stripe.
+    for (page_id_t page_id : {150, 7, 70, 8, 199}) {
+      dm.DeallocatePage(page_id);
+    }
+    dm.DeallocatePage(7);
+    EXPECT_EQ(5, dm.GetNumFreePages());
+    EXPECT_EQ(7, dm.AllocateFreePage());
+    EXPECT_EQ(199, dm.AllocateFreePage(4, 3));
+    EXPECT_EQ(INVALID_PAGE_ID, dm.AllocateFreePage(4, 1));
+    EXPECT_EQ(3, dm.GetNumFreePages());
+
+    // Scenario: changes to the map reach the .fpm file, behind the page size, in one batch when it is synced.
+    EXPECT_EQ(sizeof(uint64_t), std::filesystem::file_size("test.fpm"));
+    dm.SyncFreePageMap();
+    EXPECT_EQ(5 * sizeof(uint64_t), std::filesystem::file_size("test.fpm"));
+    dm.ShutDown();
+  }
+
+  // Scenario: the free pages and the end of the file survive reopening the database.
+  auto dm = DiskManager("test.db");
+  EXPECT_EQ(200, dm.GetNumPages());
+  EXPECT_EQ(3, dm.GetNumFreePages());
+  EXPECT_EQ(8, dm.AllocateFreePage());
+  EXPECT_EQ(70, dm.AllocateFreePage());
+  EXPECT_EQ(150, dm.AllocateFreePage());
+  EXPECT_EQ(INVALID_PAGE_ID, dm.AllocateFreePage());
+  dm.DeallocatePage(42);
+  dm.ShutDown();
+
+  // Scenario: the map left over from a database whose file was removed does not carry over to a new one.
+  remove("test.db");
+  auto new_dm = DiskManager("test.db");
+  EXPECT_EQ(0, new_dm.GetNumPages());
+  EXPECT_EQ(0, new_dm.GetNumFreePages());
+  EXPECT_EQ(INVALID_PAGE_ID, new_dm.AllocateFreePage());
+  new_dm.ShutDown();
+}
+
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ReadWriteLogTest) {
   char buf[16] = {0};
@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler_test.cpp
+//
+// Identification: test/storage/disk_scheduler_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_scheduler.h"
+
+namespace bustub {
+
+/** Counts the vectored writes it receives. */
+class CountingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void WritePages(page_id_t page_id, const std::vector<const char *> &pages) override {
+    vectored_writes_++;
+    DiskManagerUnlimitedMemory::WritePages(page_id, pages);
+  }
+
+  std::atomic<size_t> vectored_writes_{0};
+};
+
+// NOLINTNEXTLINE
+TEST(DiskSchedulerTest, ScheduleWriteReadPageTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+
+  auto dm = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto disk_scheduler = std::make_unique<DiskScheduler>(dm.get());
+
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  auto promise1 = disk_scheduler->CreatePromise();
+  auto future1 = promise1.get_future();
+  auto promise2 = disk_scheduler->CreatePromise();
+  auto future2 = promise2.get_future();
+
+  // The read is scheduled right behind the write to the same page and must observe it.
+  disk_scheduler->Schedule({/*is_write=*/true, data, /*page_id=*/0, std::move(promise1)});
+  disk_scheduler->Schedule({/*is_write=*/false, buf, /*page_id=*/0, std::move(promise2)});
+
+  ASSERT_TRUE(future1.get());
+  ASSERT_TRUE(future2.get());
+  ASSERT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+}
+
+// NOLINTNEXTLINE
+TEST(DiskSchedulerTest, ParallelRequestsTest) {
+  const size_t num_workers = 4;
+  const size_t latency_ms = 50;
+
+  auto dm = std::make_unique<DiskManagerUnlimitedMemory>();
+  dm->SetLatency(latency_ms);
+  auto disk_scheduler = std::make_unique<DiskScheduler>(dm.get(), num_workers);
+
+  std::vector<std::vector<char>> pages(num_workers, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<std::future<bool>> futures;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_workers; ++i) {
+    pages[i][0] = static_cast<char>('a' + i);
+    auto promise = disk_scheduler->CreatePromise();
+    futures.emplace_back(promise.get_future());
+    disk_scheduler->Schedule({true, pages[i].data(), static_cast<page_id_t>(i), std::move(promise)});
+  }
+  for (auto &future : futures) {
+    ASSERT_TRUE(future.get());
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+  // Writes to pages owned by different workers overlap instead of paying the latency one after another.
+  EXPECT_LT(elapsed.count(), static_cast<int64_t>(num_workers * latency_ms));
+
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  for (size_t i = 0; i < num_workers; ++i) {
+    disk_scheduler->ReadPage(static_cast<page_id_t>(i), buf);
+    EXPECT_EQ(static_cast<char>('a' + i), buf[0]);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(DiskSchedulerTest, CoalesceWritePagesTest) {
+  auto dm = std::make_unique<CountingDiskManager>();
+  auto disk_scheduler = std::make_unique<DiskScheduler>(dm.get());
+
+  // Three runs, handed over out of order: 1-3, 5 and 7-8.
+  const std::vector<page_id_t> page_ids{8, 3, 1, 5, 2, 7};
+  std::vector<std::vector<char>> pages(page_ids.size(), std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<std::pair<page_id_t, char *>> batch;
+  for (size_t i = 0; i < page_ids.size(); ++i) {
+    pages[i][0] = static_cast<char>('a' + page_ids[i]);
+    batch.emplace_back(page_ids[i], pages[i].data());
+  }
+  disk_scheduler->WritePages(batch);
+
+  // The single page run goes through WritePage.
+  EXPECT_EQ(2, dm->vectored_writes_);
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  for (auto page_id : page_ids) {
+    disk_scheduler->ReadPage(page_id, buf);
+    EXPECT_EQ(static_cast<char>('a' + page_id), buf[0]);
+  }
+}
+
+}  // namespace bustub
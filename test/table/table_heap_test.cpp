@@ -0,0 +1,524 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_heap_test.cpp
+//
+// Identification: test/table/table_heap_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/page/overflow_page.h"
+#include "storage/table/free_space_map.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/tuple.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(FreeSpaceMapTest, SearchTest) {
+  FreeSpaceMap free_space_map(BUSTUB_PAGE_SIZE);
+  EXPECT_EQ(INVALID_PAGE_ID, free_space_map.Search(1));
+
+  free_space_map.Update(1, 4000);
+  free_space_map.Update(2, 100);
+  free_space_map.Update(3, 2000);
+  EXPECT_EQ(3, free_space_map.GetNumPages());
+
+  // Scenario: only pages with room are offered, and consecutive searches rotate over them.
+  EXPECT_EQ(1, free_space_map.Search(3000));
+  EXPECT_EQ(3, free_space_map.Search(1500));
+  EXPECT_EQ(1, free_space_map.Search(1500));
+  EXPECT_EQ(3, free_space_map.Search(1500));
+  EXPECT_EQ(INVALID_PAGE_ID, free_space_map.Search(BUSTUB_PAGE_SIZE));
+
+  // Scenario: free space is rounded down, a page is never offered for more than it had.
+  EXPECT_EQ(INVALID_PAGE_ID, free_space_map.Search(4001));
+  free_space_map.Update(1, 0);
+  EXPECT_EQ(INVALID_PAGE_ID, free_space_map.Search(3000));
+  EXPECT_EQ(3, free_space_map.GetNumPages());
+
+  // Scenario: a removed page is neither offered nor listed, and is added again at the end.
+  EXPECT_EQ((std::vector<page_id_t>{1, 2, 3}), free_space_map.GetPageIds());
+  free_space_map.Remove(3);
+  EXPECT_FALSE(free_space_map.Contains(3));
+  EXPECT_EQ(INVALID_PAGE_ID, free_space_map.Search(1500));
+  EXPECT_EQ((std::vector<page_id_t>{1, 2}), free_space_map.GetPageIds());
+  free_space_map.Update(3, 2000);
+  EXPECT_EQ(3, free_space_map.Search(1500));
+  EXPECT_EQ((std::vector<page_id_t>{1, 2, 3}), free_space_map.GetPageIds());
+}
+
+class TableHeapTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    disk_manager_ = std::make_unique<DiskManagerUnlimitedMemory>();
+    bpm_ = std::make_unique<BufferPoolManager>(64, disk_manager_.get());
+    txn_ = std::make_unique<Transaction>(0);
+    table_ = std::make_unique<TableHeap>(bpm_.get(), nullptr, nullptr, txn_.get());
+  }
+
+  /** @return a tuple of about 100 bytes */
+  auto MakeTuple(int i) -> Tuple {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(90, 'x'))};
+    return {values, &schema_};
+  }
+
+  Schema schema_{std::vector<Column>{{"a", TypeId::INTEGER}, {"b", TypeId::VARCHAR, 100}}};
+  std::unique_ptr<DiskManagerUnlimitedMemory> disk_manager_;
+  std::unique_ptr<BufferPoolManager> bpm_;
+  std::unique_ptr<Transaction> txn_;
+  std::unique_ptr<TableHeap> table_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, InsertReusesFreeSpaceTest) {
+  std::vector<RID> rids;
+  std::set<page_id_t> pages;
+  for (int i = 0; i < 1000; ++i) {
+    RID rid;
+    ASSERT_TRUE(table_->InsertTuple(MakeTuple(i), &rid, txn_.get()));
+    rids.push_back(rid);
+    pages.insert(rid.GetPageId());
+  }
+  EXPECT_EQ(table_->GetFirstPageId(), rids.front().GetPageId());
+
+  // Scenario: space freed in the middle of the table is filled before the table grows.
+  const page_id_t middle = rids[rids.size() / 2].GetPageId();
+  size_t freed = 0;
+  for (const auto &rid : rids) {
+    if (rid.GetPageId() == middle) {
+      table_->ApplyDelete(rid, txn_.get());
+      freed++;
+    }
+  }
+  size_t refilled = 0;
+  for (size_t i = 0; i < freed; ++i) {
+    RID rid;
+    ASSERT_TRUE(table_->InsertTuple(MakeTuple(static_cast<int>(i)), &rid, txn_.get()));
+    EXPECT_EQ(1, pages.count(rid.GetPageId()));
+    refilled += rid.GetPageId() == middle ? 1 : 0;
+  }
+  EXPECT_GT(refilled, 0);
+
+  size_t count = 0;
+  for (auto it = table_->Begin(txn_.get()); it != table_->End(); ++it) {
+    count++;
+  }
+  EXPECT_EQ(rids.size(), count);
+
+  // Scenario: reopening the table rebuilds the free space map, and inserts keep filling the existing pages.
+  table_ = std::make_unique<TableHeap>(bpm_.get(), nullptr, nullptr, table_->GetFirstPageId());
+  RID rid;
+  ASSERT_TRUE(table_->InsertTuple(MakeTuple(0), &rid, txn_.get()));
+  EXPECT_EQ(1, pages.count(rid.GetPageId()));
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, InsertTuplesTest) {
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < 1000; ++i) {
+    tuples.push_back(MakeTuple(i));
+  }
+  std::vector<RID> rids;
+  ASSERT_TRUE(table_->InsertTuples(tuples, &rids, txn_.get()));
+  ASSERT_EQ(tuples.size(), rids.size());
+
+  // Scenario: the rids are returned in the order of the tuples, and every rid holds its tuple.
+  for (size_t i = 0; i < rids.size(); ++i) {
+    Tuple tuple;
+    ASSERT_TRUE(table_->GetTuple(rids[i], &tuple, txn_.get()));
+    EXPECT_EQ(static_cast<int>(i), tuple.GetValue(&schema_, 0).GetAs<int32_t>());
+  }
+  size_t count = 0;
+  for (auto it = table_->Begin(txn_.get()); it != table_->End(); ++it) {
+    count++;
+  }
+  EXPECT_EQ(tuples.size(), count);
+
+  // Scenario: a batch holding a tuple larger than a page inserts nothing.
+  std::vector<Value> values{ValueFactory::GetIntegerValue(0),
+                            ValueFactory::GetVarcharValue(std::string(BUSTUB_PAGE_SIZE, 'x'))};
+  std::vector<Tuple> oversized{MakeTuple(0), Tuple(values, &schema_)};
+  Transaction txn(1);
+  rids.clear();
+  EXPECT_FALSE(table_->InsertTuples(oversized, &rids, &txn));
+  EXPECT_TRUE(rids.empty());
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, TupleViewTest) {
+  std::vector<RID> rids;
+  for (int i = 0; i < 200; ++i) {
+    RID rid;
+    ASSERT_TRUE(table_->InsertTuple(MakeTuple(i), &rid, txn_.get()));
+    rids.push_back(rid);
+  }
+
+  // Scenario: a view scan sees every tuple, in the same order as a copying scan.
+  std::vector<Tuple> materialized;
+  auto copy_it = table_->Begin(txn_.get());
+  for (auto it = table_->ViewBegin(); it != table_->ViewEnd(); ++it, ++copy_it) {
+    ASSERT_NE(table_->End(), copy_it);
+    EXPECT_EQ(copy_it->GetRid().Get(), it->GetRid().Get());
+    EXPECT_EQ(copy_it->GetValue(&schema_, 0).GetAs<int32_t>(), it->GetValue(&schema_, 0).GetAs<int32_t>());
+    EXPECT_FALSE((*it)->IsAllocated());
+    materialized.push_back(it->Materialize());
+  }
+  EXPECT_EQ(table_->End(), copy_it);
+
+  // Scenario: materialized tuples outlive the scan, which leaves no page pinned behind.
+  ASSERT_EQ(rids.size(), materialized.size());
+  for (size_t i = 0; i < materialized.size(); ++i) {
+    EXPECT_TRUE(materialized[i].IsAllocated());
+    EXPECT_EQ(static_cast<int>(i), materialized[i].GetValue(&schema_, 0).GetAs<int32_t>());
+  }
+  auto *first_page = bpm_->FetchPage(table_->GetFirstPageId());
+  EXPECT_EQ(1, first_page->GetPinCount());
+  bpm_->UnpinPage(table_->GetFirstPageId(), false);
+
+  // Scenario: a view keeps its page pinned until it is released, even after the iterator moved on.
+  TupleView view;
+  ASSERT_TRUE(table_->GetTupleView(rids.back(), &view));
+  TupleView copy = view;
+  EXPECT_EQ(199, copy.GetValue(&schema_, 0).GetAs<int32_t>());
+  auto *last_page = bpm_->FetchPage(rids.back().GetPageId());
+  EXPECT_EQ(2, last_page->GetPinCount());
+  view.Release();
+  EXPECT_EQ(2, last_page->GetPinCount());
+  copy.Release();
+  EXPECT_EQ(1, last_page->GetPinCount());
+  bpm_->UnpinPage(rids.back().GetPageId(), false);
+  EXPECT_FALSE(table_->GetTupleView(RID(rids.back().GetPageId(), 1000), &view));
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, VacuumTest) {
+  std::vector<RID> rids;
+  std::set<page_id_t> pages;
+  for (int i = 0; i < 1000; ++i) {
+    RID rid;
+    ASSERT_TRUE(table_->InsertTuple(MakeTuple(i), &rid, txn_.get()));
+    rids.push_back(rid);
+    pages.insert(rid.GetPageId());
+  }
+  ASSERT_GT(pages.size(), 4);
+
+  // Scenario: deleting every tuple but those on the first and last page leaves empty pages, which vacuum releases.
+  // The page an iterator is positioned on is not released under it, though, and the iterator moves on past the
+  // released pages.
+  const page_id_t first = rids.front().GetPageId();
+  const page_id_t last = rids.back().GetPageId();
+  const RID second_page_rid =
+      *std::find_if(rids.begin(), rids.end(), [&](auto rid) { return rid.GetPageId() != first; });
+  auto it = std::make_unique<TableIterator>(table_.get(), second_page_rid, txn_.get());
+  size_t kept = 0;
+  for (const auto &rid : rids) {
+    if (rid.GetPageId() == first || rid.GetPageId() == last) {
+      kept++;
+    } else {
+      table_->ApplyDelete(rid, txn_.get());
+    }
+  }
+  auto stats = table_->Vacuum();
+  EXPECT_EQ(pages.size(), stats.pages_);
+  EXPECT_EQ(pages.size() - 3, stats.released_pages_);
+  EXPECT_GE(stats.reclaimed_bytes_, stats.released_pages_ * BUSTUB_PAGE_SIZE);
+  ++*it;
+  EXPECT_EQ(last, (*it)->GetRid().GetPageId());
+  it.reset();
+  stats = table_->Vacuum();
+  EXPECT_EQ(3, stats.pages_);
+  EXPECT_EQ(1, stats.released_pages_);
+
+  size_t count = 0;
+  for (auto it = table_->Begin(txn_.get()); it != table_->End(); ++it) {
+    EXPECT_TRUE(it->GetRid().GetPageId() == first || it->GetRid().GetPageId() == last);
+    count++;
+  }
+  EXPECT_EQ(kept, count);
+
+  // Scenario: the table keeps working, and grows again into released pages.
+  for (int i = 0; i < 500; ++i) {
+    RID rid;
+    ASSERT_TRUE(table_->InsertTuple(MakeTuple(i), &rid, txn_.get()));
+  }
+  count = 0;
+  for (auto it = table_->Begin(txn_.get()); it != table_->End(); ++it) {
+    count++;
+  }
+  EXPECT_EQ(kept + 500, count);
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, ConcurrentVacuumTest) {
+  std::vector<RID> rids;
+  for (int i = 0; i < 2000; ++i) {
+    RID rid;
+    ASSERT_TRUE(table_->InsertTuple(MakeTuple(i), &rid, txn_.get()));
+    rids.push_back(rid);
+  }
+  // Delete the odd tuples up front and the even ones, but for every 100th, while readers scan.
+  for (size_t i = 1; i < rids.size(); i += 2) {
+    table_->ApplyDelete(rids[i], txn_.get());
+  }
+
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int tid = 0; tid < 2; ++tid) {
+    readers.emplace_back([&] {
+      Transaction txn(1);
+      while (!done) {
+        int prev = -1;
+        for (auto it = table_->Begin(&txn); it != table_->End(); ++it) {
+          auto value = it->GetValue(&schema_, 0).GetAs<int32_t>();
+          EXPECT_LT(prev, value);
+          EXPECT_EQ(0, value % 2);
+          prev = value;
+        }
+      }
+    });
+  }
+  std::thread vacuum([&] {
+    while (!done) {
+      table_->Vacuum();
+    }
+  });
+  for (size_t i = 2; i < rids.size(); i += 2) {
+    if (i % 100 != 0) {
+      table_->ApplyDelete(rids[i], txn_.get());
+    }
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  vacuum.join();
+
+  table_->Vacuum();
+  size_t count = 0;
+  for (auto it = table_->Begin(txn_.get()); it != table_->End(); ++it) {
+    EXPECT_EQ(0, it->GetValue(&schema_, 0).GetAs<int32_t>() % 100);
+    count++;
+  }
+  EXPECT_EQ(rids.size() / 100, count);
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, OverflowTest) {
+  table_ = std::make_unique<TableHeap>(bpm_.get(), nullptr, nullptr, txn_.get(), &schema_);
+  const auto large_length = 5 * OverflowPage::Capacity(BUSTUB_PAGE_SIZE);
+  auto make_large_tuple = [&](int i) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i),
+                              ValueFactory::GetVarcharValue(std::string(large_length - 1, static_cast<char>('a' + i)))};
+    return Tuple{values, &schema_};
+  };
+
+  // Scenario: a varchar larger than a page is stored on overflow pages, a short one stays in the row.
+  RID small_rid;
+  ASSERT_TRUE(table_->InsertTuple(MakeTuple(0), &small_rid, txn_.get()));
+  Tuple small;
+  ASSERT_TRUE(table_->GetTuple(small_rid, &small, txn_.get()));
+  EXPECT_EQ(MakeTuple(0).GetLength(), small.GetLength());
+
+  std::vector<RID> rids;
+  for (int i = 0; i < 10; i++) {
+    RID rid;
+    ASSERT_TRUE(table_->InsertTuple(make_large_tuple(i), &rid, txn_.get()));
+    rids.push_back(rid);
+  }
+  Tuple large;
+  TupleView view;
+  ASSERT_TRUE(table_->GetTupleView(rids[3], &view));
+  EXPECT_LT(view->GetLength(), 100);
+  view.Release();
+  ASSERT_TRUE(table_->GetTuple(rids[3], &large, txn_.get()));
+  EXPECT_EQ(3, large.GetValue(&schema_, 0).GetAs<int32_t>());
+  EXPECT_EQ(std::string(large_length - 1, 'd'), large.GetValue(&schema_, 1).ToString());
+
+  // Scenario: a scan that does not read the varchar never fetches its overflow pages, neither through views nor
+  // through copies. The copies keep the overflow pointers and read the values when they are asked for.
+  auto fetches = [&]() {
+    auto stats = bpm_->GetStats();
+    return stats.hits_ + stats.misses_;
+  };
+  auto before = fetches();
+  int sum = 0;
+  for (auto it = table_->ViewBegin(); it != table_->ViewEnd(); ++it) {
+    sum += it->GetValue(&schema_, 0).GetAs<int32_t>();
+  }
+  EXPECT_EQ(45, sum);
+  EXPECT_LT(fetches() - before, 10);
+  before = fetches();
+  sum = 0;
+  std::vector<Tuple> copies;
+  for (auto it = table_->Begin(txn_.get()); it != table_->End(); ++it) {
+    copies.push_back(*it);
+    sum += it->GetValue(&schema_, 0).GetAs<int32_t>();
+  }
+  EXPECT_EQ(45, sum);
+  EXPECT_LT(fetches() - before, 10);
+  before = fetches();
+  size_t total_length = 0;
+  for (const auto &copy : copies) {
+    total_length += copy.GetValue(&schema_, 1).GetLength();
+  }
+  EXPECT_GE(fetches() - before, 50);
+  EXPECT_EQ(10 * large_length + MakeTuple(0).GetValue(&schema_, 1).GetLength(), total_length);
+
+  // Scenario: deleting a tuple retires its overflow pages, so a copy still reads them. Vacuum releases them, and the
+  // next large tuple reuses them.
+  auto free_pages = disk_manager_->GetNumFreePages();
+  Tuple deleted;
+  ASSERT_TRUE(table_->GetTuple(rids[0], &deleted, txn_.get()));
+  table_->ApplyDelete(rids[0], txn_.get());
+  EXPECT_EQ(free_pages, disk_manager_->GetNumFreePages());
+  EXPECT_EQ(std::string(large_length - 1, 'a'), deleted.GetValue(&schema_, 1).ToString());
+  EXPECT_EQ(1, table_->Vacuum().released_overflow_chains_);
+  EXPECT_EQ(free_pages + 5, disk_manager_->GetNumFreePages());
+  EXPECT_EQ(0, table_->Vacuum().released_overflow_chains_);
+  ASSERT_TRUE(table_->InsertTuple(make_large_tuple(0), &rids[0], txn_.get()));
+  EXPECT_EQ(free_pages, disk_manager_->GetNumFreePages());
+
+  // Scenario: an update gets its own overflow pages. The old ones are retired when the update commits, the new ones
+  // when it is rolled back.
+  ASSERT_TRUE(table_->GetTuple(rids[1], &large, txn_.get()));
+  ASSERT_TRUE(table_->UpdateTuple(large, rids[1], txn_.get()));
+  auto old_tuple = txn_->GetWriteSet()->back().tuple_;
+  free_pages = disk_manager_->GetNumFreePages();
+  table_->ApplyUpdate(old_tuple, txn_.get());
+  EXPECT_EQ(free_pages, disk_manager_->GetNumFreePages());
+  table_->Vacuum();
+  EXPECT_EQ(free_pages + 5, disk_manager_->GetNumFreePages());
+  ASSERT_TRUE(table_->UpdateTuple(make_large_tuple(7), rids[1], txn_.get()));
+  old_tuple = txn_->GetWriteSet()->back().tuple_;
+  table_->RollbackUpdate(old_tuple, rids[1], txn_.get());
+  EXPECT_EQ(free_pages, disk_manager_->GetNumFreePages());
+  table_->Vacuum();
+  EXPECT_EQ(free_pages + 5, disk_manager_->GetNumFreePages());
+  ASSERT_TRUE(table_->GetTuple(rids[1], &large, txn_.get()));
+  EXPECT_EQ(std::string(large_length - 1, 'b'), large.GetValue(&schema_, 1).ToString());
+
+  // Scenario: a batch insert moves out the large varchars of the tuples that have them.
+  std::vector<RID> batch_rids;
+  ASSERT_TRUE(table_->InsertTuples({MakeTuple(1), make_large_tuple(2), MakeTuple(3)}, &batch_rids, txn_.get()));
+  ASSERT_EQ(3, batch_rids.size());
+  ASSERT_TRUE(table_->GetTuple(batch_rids[1], &large, txn_.get()));
+  EXPECT_EQ(std::string(large_length - 1, 'c'), large.GetValue(&schema_, 1).ToString());
+  ASSERT_TRUE(table_->GetTuple(batch_rids[2], &small, txn_.get()));
+  EXPECT_EQ(3, small.GetValue(&schema_, 0).GetAs<int32_t>());
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, ConcurrentInsertTest) {
+  const int num_threads = 4;
+  const int num_inserts = 500;
+
+  std::vector<std::vector<RID>> rids(num_threads);
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([&, tid] {
+      Transaction txn(tid + 1);
+      for (int i = 0; i < num_inserts; ++i) {
+        RID rid;
+        ASSERT_TRUE(table_->InsertTuple(MakeTuple(tid * num_inserts + i), &rid, &txn));
+        rids[tid].push_back(rid);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::set<int64_t> all_rids;
+  for (const auto &thread_rids : rids) {
+    for (const auto &rid : thread_rids) {
+      all_rids.insert(rid.Get());
+    }
+  }
+  EXPECT_EQ(num_threads * num_inserts, all_rids.size());
+
+  std::set<int> values;
+  for (auto it = table_->Begin(txn_.get()); it != table_->End(); ++it) {
+    values.insert(it->GetValue(&schema_, 0).GetAs<int32_t>());
+  }
+  EXPECT_EQ(num_threads * num_inserts, values.size());
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, ParallelScanTest) {
+  const int num_tuples = 1000;
+  for (int i = 0; i < num_tuples; ++i) {
+    RID rid;
+    ASSERT_TRUE(table_->InsertTuple(MakeTuple(i), &rid, txn_.get()));
+    if (i % 10 == 0) {
+      table_->ApplyDelete(rid, txn_.get());
+    }
+  }
+
+  // Scenario: every live tuple is visited exactly once, by one of the threads, and every thread reads its own pages.
+  const size_t num_threads = 4;
+  std::vector<std::vector<int>> values(num_threads);
+  std::vector<std::set<page_id_t>> pages(num_threads);
+  table_->ParallelScan(num_threads, [&](size_t thread, const Tuple &tuple) {
+    values[thread].push_back(tuple.GetValue(&schema_, 0).GetAs<int32_t>());
+    pages[thread].insert(tuple.GetRid().GetPageId());
+  });
+  std::set<int> all_values;
+  std::set<page_id_t> all_pages;
+  for (size_t thread = 0; thread < num_threads; ++thread) {
+    EXPECT_FALSE(values[thread].empty());
+    all_values.insert(values[thread].begin(), values[thread].end());
+    all_pages.insert(pages[thread].begin(), pages[thread].end());
+  }
+  EXPECT_EQ(num_tuples - num_tuples / 10, all_values.size());
+  EXPECT_EQ(pages[0].size() + pages[1].size() + pages[2].size() + pages[3].size(), all_pages.size());
+  for (int i = 0; i < num_tuples; ++i) {
+    EXPECT_EQ(i % 10 != 0, all_values.count(i) == 1);
+  }
+
+  // Scenario: a small buffer pool limits the number of threads, so that the scan cannot pin all of its frames.
+  bpm_->FlushAllPages();
+  BufferPoolManager small_bpm(8, disk_manager_.get());
+  TableHeap small_pool_table(&small_bpm, nullptr, nullptr, table_->GetFirstPageId());
+  std::atomic<size_t> num_visited{0};
+  small_pool_table.ParallelScan(num_threads, [&](size_t thread, const Tuple &tuple) {
+    EXPECT_LT(thread, 2);
+    num_visited++;
+  });
+  EXPECT_EQ(all_values.size(), num_visited);
+
+  // Scenario: with read-ahead on, no more threads than the window scan, so they do not recycle each other's pages.
+  EXPECT_EQ(num_threads, table_->GetScanThreads(num_threads));
+  bpm_->SetReadAheadWindow(2);
+  EXPECT_EQ(2, table_->GetScanThreads(num_threads));
+  bpm_->SetReadAheadWindow(0);
+
+  // Scenario: a table with a single page is read by a single thread.
+  TableHeap small_table(bpm_.get(), nullptr, nullptr, txn_.get());
+  RID rid;
+  ASSERT_TRUE(small_table.InsertTuple(MakeTuple(0), &rid, txn_.get()));
+  size_t visited = 0;
+  small_table.ParallelScan(num_threads, [&](size_t thread, const Tuple &tuple) {
+    EXPECT_EQ(0, thread);
+    visited++;
+  });
+  EXPECT_EQ(1, visited);
+}
+
+}  // namespace bustub
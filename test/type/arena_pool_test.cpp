@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arena_pool_test.cpp
+//
+// Identification: test/type/arena_pool_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "gtest/gtest.h"
+#include "storage/table/tuple.h"
+#include "type/arena_pool.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ArenaPoolTest, AllocateTest) {
+  ArenaPool pool;
+  EXPECT_EQ(0, pool.GetBytesReserved());
+
+  // Scenario: allocations are aligned for any type and do not overlap.
+  std::vector<char *> ptrs;
+  for (size_t size = 1; size < 3000; size += 37) {
+    auto *ptr = static_cast<char *>(pool.Allocate(size));
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(ptr) % alignof(std::max_align_t));
+    memset(ptr, static_cast<int>(size % 128), size);
+    ptrs.push_back(ptr);
+  }
+  for (size_t i = 0; i < ptrs.size(); ++i) {
+    size_t size = 1 + i * 37;
+    EXPECT_EQ(static_cast<char>(size % 128), ptrs[i][size - 1]);
+  }
+  EXPECT_GE(pool.GetBytesReserved(), pool.GetBytesAllocated());
+
+  // Scenario: a reset returns everything but one block, which later allocations reuse.
+  pool.Reset();
+  EXPECT_EQ(0, pool.GetBytesAllocated());
+  auto reserved = pool.GetBytesReserved();
+  EXPECT_LE(reserved, ArenaPool::MAX_BLOCK_SIZE);
+  pool.Allocate(16);
+  EXPECT_EQ(reserved, pool.GetBytesReserved());
+}
+
+// NOLINTNEXTLINE
+TEST(ArenaPoolTest, TupleAndValueTest) {
+  ArenaPool pool;
+  Schema schema{std::vector<Column>{{"a", TypeId::INTEGER}, {"b", TypeId::VARCHAR, 100}}};
+
+  // Scenario: tuples and varchars built on the pool read back the same, and do not own their data.
+  std::string text(50, 'y');
+  auto varchar = ValueFactory::GetVarcharValue(text, &pool);
+  EXPECT_EQ(text, varchar.ToString());
+  auto clone = ValueFactory::Clone(varchar, &pool);
+  EXPECT_NE(varchar.GetData(), clone.GetData());
+  EXPECT_EQ(CmpBool::CmpTrue, clone.CompareEquals(varchar));
+
+  Tuple tuple({ValueFactory::GetIntegerValue(7), varchar}, &schema, &pool);
+  EXPECT_FALSE(tuple.IsAllocated());
+  EXPECT_EQ(7, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+  EXPECT_EQ(text, tuple.GetValue(&schema, 1).ToString());
+  Tuple copy = tuple;
+  EXPECT_EQ(tuple.GetData(), copy.GetData());
+  EXPECT_GE(pool.GetBytesAllocated(), tuple.GetLength() + 2 * (text.size() + 1));
+
+  // Scenario: a hash table allocates its entries from the pool.
+  auto before = pool.GetBytesAllocated();
+  std::unordered_map<int, int, std::hash<int>, std::equal_to<int>, ArenaAllocator<std::pair<const int, int>>> map{
+      ArenaAllocator<std::pair<const int, int>>{&pool}};
+  for (int i = 0; i < 1000; ++i) {
+    map[i] = i;
+  }
+  EXPECT_EQ(1000, map.size());
+  EXPECT_GT(pool.GetBytesAllocated(), before + 1000 * sizeof(std::pair<const int, int>));
+}
+
+}  // namespace bustub
@@ -1,3 +1,4 @@
+#include <atomic>
 #include <chrono>
 #include <iostream>
 #include <memory>
@@ -34,6 +35,9 @@ static const size_t BUSTUB_GET_THREAD = 8;
 static const size_t LRU_K_SIZE = 16;
 static const size_t BUSTUB_PAGE_CNT = 6400;
 static const size_t BUSTUB_BPM_SIZE = 64;
+static const size_t BUSTUB_MAX_SCALING_THREAD = 32;
+/** Memory of the pool in --compare-page-sizes: 1024 frames of 4K, and still enough 64K frames for every thread. */
+static const size_t BUSTUB_BPM_BYTES = 4 << 20;
 
 struct BpmTotalMetrics {
   uint64_t scan_cnt_{0};
@@ -100,16 +104,185 @@ struct BpmMetrics {
   }
 };
 
+/**
+ * Run zipfian point lookups from `num_threads` threads for `duration_ms` and return the total number of lookups.
+ */
+auto RunGetWorkload(bustub::BufferPoolManager *bpm, const std::vector<bustub::page_id_t> &page_ids,
+                    size_t num_threads, uint64_t duration_ms) -> uint64_t {
+  std::atomic<uint64_t> total_cnt{0};
+  std::vector<std::thread> threads;
+  for (size_t thread_id = 0; thread_id < num_threads; thread_id++) {
+    threads.emplace_back([bpm, &page_ids, duration_ms, &total_cnt] {
+      std::random_device r;
+      std::default_random_engine gen(r());
+      zipfian_int_distribution<size_t> dist(0, page_ids.size() - 1, 0.8);
+      auto start = ClockMs();
+      uint64_t cnt = 0;
+      while (ClockMs() - start < duration_ms) {
+        auto page_idx = dist(gen);
+        auto guard = bpm->FetchPageRead(page_ids[page_idx]);
+        if (guard.GetData()[page_idx % 1024] == 0) {
+          throw std::runtime_error("invalid data");
+        }
+        cnt++;
+      }
+      total_cnt += cnt;
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return total_cnt;
+}
+
+/**
+ * Scan every page over and over with AccessType::Scan, touching each page twice like TableIterator does, until
+ * `stop` is set. Like TableIterator, the scan hints the page it moves to next. Return the number of fetches.
+ */
+auto RunScanWorkload(bustub::BufferPoolManager *bpm, const std::vector<bustub::page_id_t> &page_ids,
+                     const std::atomic<bool> &stop) -> uint64_t {
+  size_t page_idx = 0;
+  uint64_t cnt = 0;
+  while (!stop) {
+    for (int tuple = 0; tuple < 2; tuple++) {
+      auto *page = bpm->FetchPage(page_ids[page_idx], bustub::AccessType::Scan);
+      if (page == nullptr) {
+        continue;
+      }
+      // The pages carry no chain, so only the hinted next page is read ahead.
+      bpm->ReadAheadHint(page_ids[page_idx], page_ids[(page_idx + 1) % page_ids.size()], nullptr);
+      bpm->UnpinPage(page->GetPageId(), false, bustub::AccessType::Scan);
+      cnt++;
+    }
+    page_idx = (page_idx + 1) % page_ids.size();
+  }
+  return cnt;
+}
+
+/**
+ * Forwards to another disk manager and counts the pages read, so that the hit ratio of the pool can be derived. Every
+ * virtual the buffer pool and the disk scheduler call is forwarded, so the pool sees the state of the real file.
+ */
+class CountingDiskManager : public bustub::DiskManager {
+ public:
+  explicit CountingDiskManager(bustub::DiskManager *disk_manager)
+      : bustub::DiskManager(disk_manager->GetPageSize()), disk_manager_(disk_manager) {}
+
+  void WritePage(bustub::page_id_t page_id, const char *page_data) override {
+    disk_manager_->WritePage(page_id, page_data);
+  }
+
+  void WritePages(bustub::page_id_t page_id, const std::vector<const char *> &pages) override {
+    disk_manager_->WritePages(page_id, pages);
+  }
+
+  void ReadPage(bustub::page_id_t page_id, char *page_data) override {
+    reads_++;
+    disk_manager_->ReadPage(page_id, page_data);
+  }
+
+  auto AllocateFreePage(uint32_t num_stripes, uint32_t stripe) -> bustub::page_id_t override {
+    return disk_manager_->AllocateFreePage(num_stripes, stripe);
+  }
+
+  void DeallocatePage(bustub::page_id_t page_id) override { disk_manager_->DeallocatePage(page_id); }
+
+  void SyncFreePageMap() override { disk_manager_->SyncFreePageMap(); }
+
+  auto GetNumFreePages() -> size_t override { return disk_manager_->GetNumFreePages(); }
+
+  auto GetNumPages() const -> bustub::page_id_t override { return disk_manager_->GetNumPages(); }
+
+  std::atomic<uint64_t> reads_{0};
+
+ private:
+  bustub::DiskManager *disk_manager_;
+};
+
+/** Create `num_pages` pages, each with a non-zero byte at `index % 1024`, and return their ids. */
+auto CreatePages(bustub::BufferPoolManager *bpm, size_t num_pages = BUSTUB_PAGE_CNT) -> std::vector<bustub::page_id_t> {
+  std::vector<bustub::page_id_t> page_ids;
+  for (size_t i = 0; i < num_pages; i++) {
+    bustub::page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    if (page == nullptr) {
+      throw std::runtime_error("new page failed");
+    }
+    char &ch = page->GetData()[i % 1024];
+    ch = 1;
+
+    bpm->UnpinPage(page_id, true);
+    page_ids.push_back(page_id);
+  }
+  return page_ids;
+}
+
+auto ParseReplacerType(const std::string &name) -> bustub::ReplacerType {
+  if (name == "lru-k") {
+    return bustub::ReplacerType::LRUK;
+  }
+  if (name == "lru") {
+    return bustub::ReplacerType::LRU;
+  }
+  if (name == "clock") {
+    return bustub::ReplacerType::Clock;
+  }
+  if (name == "arc") {
+    return bustub::ReplacerType::ARC;
+  }
+  if (name == "2q") {
+    return bustub::ReplacerType::TwoQueue;
+  }
+  throw std::runtime_error("unknown replacer " + name);
+}
+
 // NOLINTNEXTLINE
 auto main(int argc, char **argv) -> int {
   using bustub::AccessType;
   using bustub::BufferPoolManager;
+  using bustub::DiskManager;
   using bustub::DiskManagerUnlimitedMemory;
   using bustub::page_id_t;
+  using bustub::ReplacerType;
 
   argparse::ArgumentParser program("bustub-bpm-bench");
   program.add_argument("--duration").help("run bpm bench for n milliseconds");
   program.add_argument("--latency").help("set disk latency to n milliseconds");
+  program.add_argument("--db-file").help("store the pages in this file instead of in memory");
+  program.add_argument("--direct-io")
+      .help("open --db-file with O_DIRECT")
+      .default_value(false)
+      .implicit_value(true);
+  program.add_argument("--instances").help("split the buffer pool into n instances");
+  program.add_argument("--read-ahead")
+      .help("read n pages ahead of scans, 0 to disable")
+      .default_value(std::string("8"));
+  program.add_argument("--scan-ring").help("confine scans to n frames, 0 to disable").default_value(std::string("16"));
+  program.add_argument("--scaling")
+      .help("report get throughput from 1 to 32 threads, running each step for --duration milliseconds")
+      .default_value(false)
+      .implicit_value(true);
+  program.add_argument("--page-cleaner")
+      .help("run the background page cleaner")
+      .default_value(false)
+      .implicit_value(true);
+  program.add_argument("--replacer").help("replacement policy: lru-k, lru, clock, arc or 2q").default_value(
+      std::string("lru-k"));
+  program.add_argument("--compare-replacers")
+      .help("report get throughput and hit ratio of every replacer under zipfian gets next to a scan")
+      .default_value(false)
+      .implicit_value(true);
+  program.add_argument("--page-size").help("page size in bytes, a power of two from 4096 to 65536");
+  program.add_argument("--compare-page-sizes")
+      .help(
+          "report get throughput, hit ratio and scan bandwidth at 4K, 16K and 64K pages with the same memory and "
+          "data")
+      .default_value(false)
+      .implicit_value(true);
+  program.add_argument("--scan-impact")
+      .help("report get throughput without and with a concurrent scan, running each step for --duration milliseconds")
+      .default_value(false)
+      .implicit_value(true);
 
   try {
     program.parse_args(argc, argv);
@@ -129,28 +302,150 @@ auto main(int argc, char **argv) -> int {
     latency_ms = std::stoi(program.get("--latency"));
   }
 
-  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
-  auto bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, disk_manager.get(), LRU_K_SIZE);
-  std::vector<page_id_t> page_ids;
+  size_t num_instances = bustub::BUFFER_POOL_INSTANCES;
+  if (program.present("--instances")) {
+    num_instances = std::stoi(program.get("--instances"));
+  }
 
-  fmt::print(stderr, "[info] total_page={}, duration_ms={}, latency_ms={}, lru_k_size={}, bpm_size={}\n",
-             BUSTUB_PAGE_CNT, duration_ms, latency_ms, LRU_K_SIZE, BUSTUB_BPM_SIZE);
+  auto replacer_type = ParseReplacerType(program.get("--replacer"));
 
-  for (size_t i = 0; i < BUSTUB_PAGE_CNT; i++) {
-    page_id_t page_id;
-    auto *page = bpm->NewPage(&page_id);
-    if (page == nullptr) {
-      throw std::runtime_error("new page failed");
+  size_t page_size = bustub::BUSTUB_PAGE_SIZE;
+  if (program.present("--page-size")) {
+    page_size = std::stoul(program.get("--page-size"));
+  }
+
+  if (program.get<bool>("--compare-page-sizes")) {
+    // Keep the memory of the pool and the amount of data fixed, so that larger pages mean fewer frames and pages.
+    fmt::print(stderr, "[info] page size comparison start\n");
+    fmt::print("<<< BEGIN\n");
+    for (size_t size : {4096, 16384, 65536}) {
+      DiskManagerUnlimitedMemory disk(size);
+      CountingDiskManager counting_disk(&disk);
+      auto pool_size = BUSTUB_BPM_BYTES / size;
+      auto bpm = std::make_unique<BufferPoolManager>(pool_size, &counting_disk, LRU_K_SIZE, nullptr, num_instances,
+                                                     replacer_type);
+      auto page_ids = CreatePages(bpm.get(), BUSTUB_PAGE_CNT * bustub::BUSTUB_PAGE_SIZE / size);
+      disk.SetLatency(latency_ms);
+
+      counting_disk.reads_ = 0;
+      auto get_cnt = RunGetWorkload(bpm.get(), page_ids, BUSTUB_GET_THREAD, duration_ms);
+      auto get_hit_ratio = get_cnt == 0 ? 0.0 : 1 - counting_disk.reads_ / static_cast<double>(get_cnt);
+
+      std::atomic<bool> stop{false};
+      uint64_t scan_cnt = 0;
+      std::thread scan_thread([&] { scan_cnt = RunScanWorkload(bpm.get(), page_ids, stop); });
+      std::this_thread::sleep_for(std::chrono::milliseconds(duration_ms));
+      stop = true;
+      scan_thread.join();
+
+      fmt::print("page_size={:<6} frames={:<4} pages={:<5} get: {:<12.1f} hit_ratio: {:.4f} scan: {:.1f} MB/s\n", size,
+                 pool_size, page_ids.size(), get_cnt / static_cast<double>(duration_ms) * 1000, get_hit_ratio,
+                 static_cast<double>(scan_cnt * size) / duration_ms * 1000 / (1 << 20));
     }
-    char &ch = page->GetData()[i % 1024];
-    ch = 1;
+    fmt::print(">>> END\n");
+    return 0;
+  }
 
-    bpm->UnpinPage(page_id, true);
-    page_ids.push_back(page_id);
+  std::unique_ptr<DiskManager> disk_manager;
+  DiskManagerUnlimitedMemory *memory_disk_manager = nullptr;
+  if (program.present("--db-file")) {
+    disk_manager =
+        std::make_unique<DiskManager>(program.get("--db-file"), program.get<bool>("--direct-io"), page_size);
+  } else {
+    auto unlimited_memory = std::make_unique<DiskManagerUnlimitedMemory>(page_size);
+    memory_disk_manager = unlimited_memory.get();
+    disk_manager = std::move(unlimited_memory);
+  }
+  CountingDiskManager counting_disk_manager(disk_manager.get());
+
+  auto make_bpm = [&](ReplacerType type) {
+    auto bpm = std::make_unique<BufferPoolManager>(BUSTUB_BPM_SIZE, &counting_disk_manager, LRU_K_SIZE, nullptr,
+                                                   num_instances, type);
+    bpm->SetReadAheadWindow(std::stoi(program.get("--read-ahead")));
+    bpm->SetScanRingSize(std::stoi(program.get("--scan-ring")));
+    if (program.get<bool>("--page-cleaner")) {
+      bpm->StartPageCleaner();
+    }
+    return bpm;
+  };
+
+  if (program.get<bool>("--compare-replacers")) {
+    fmt::print(stderr, "[info] replacer comparison start\n");
+    fmt::print("<<< BEGIN\n");
+    for (const auto *name : {"lru-k", "lru", "clock", "arc", "2q"}) {
+      if (memory_disk_manager != nullptr) {
+        memory_disk_manager->SetLatency(0);
+      }
+      auto bpm = make_bpm(ParseReplacerType(name));
+      auto page_ids = CreatePages(bpm.get());
+      if (memory_disk_manager != nullptr) {
+        memory_disk_manager->SetLatency(latency_ms);
+      }
+
+      counting_disk_manager.reads_ = 0;
+      std::atomic<bool> stop{false};
+      uint64_t scan_cnt = 0;
+      std::thread scan_thread([&] { scan_cnt = RunScanWorkload(bpm.get(), page_ids, stop); });
+      auto get_cnt = RunGetWorkload(bpm.get(), page_ids, BUSTUB_GET_THREAD, duration_ms);
+      stop = true;
+      scan_thread.join();
+
+      auto fetch_cnt = get_cnt + scan_cnt;
+      auto hit_ratio = fetch_cnt == 0 ? 0.0 : 1 - counting_disk_manager.reads_ / static_cast<double>(fetch_cnt);
+      fmt::print("{:<5} get: {:<12.1f} scan: {:<12.1f} hit_ratio: {:.4f}\n", name,
+                 get_cnt / static_cast<double>(duration_ms) * 1000, scan_cnt / static_cast<double>(duration_ms) * 1000,
+                 hit_ratio);
+    }
+    fmt::print(">>> END\n");
+    return 0;
   }
 
+  auto bpm = make_bpm(replacer_type);
+
+  fmt::print(stderr,
+             "[info] total_page={}, duration_ms={}, latency_ms={}, lru_k_size={}, bpm_size={}, instances={}, "
+             "read_ahead={}, scan_ring={}, direct_io={}, replacer={}, page_size={}\n",
+             BUSTUB_PAGE_CNT, duration_ms, latency_ms, LRU_K_SIZE, BUSTUB_BPM_SIZE, bpm->GetNumInstances(),
+             bpm->GetReadAheadWindow(), bpm->GetScanRingSize(), disk_manager->IsDirectIO(), program.get("--replacer"),
+             bpm->GetPageSize());
+
+  auto page_ids = CreatePages(bpm.get());
+
   // enable disk latency after creating all pages
-  disk_manager->SetLatency(latency_ms);
+  if (memory_disk_manager != nullptr) {
+    memory_disk_manager->SetLatency(latency_ms);
+  }
+  counting_disk_manager.reads_ = 0;
+
+  if (program.get<bool>("--scaling")) {
+    fmt::print(stderr, "[info] scaling benchmark start\n");
+    fmt::print("<<< BEGIN\n");
+    for (size_t num_threads = 1; num_threads <= BUSTUB_MAX_SCALING_THREAD; num_threads *= 2) {
+      auto cnt = RunGetWorkload(bpm.get(), page_ids, num_threads, duration_ms);
+      fmt::print("threads={:<2} get: {}\n", num_threads, cnt / static_cast<double>(duration_ms) * 1000);
+    }
+    fmt::print(">>> END\n");
+    return 0;
+  }
+
+  if (program.get<bool>("--scan-impact")) {
+    fmt::print(stderr, "[info] scan impact benchmark start\n");
+    auto get_cnt = RunGetWorkload(bpm.get(), page_ids, BUSTUB_GET_THREAD, duration_ms);
+    std::atomic<bool> stop{false};
+    std::thread scan_thread([&bpm, &page_ids, &stop] { RunScanWorkload(bpm.get(), page_ids, stop); });
+    auto get_cnt_with_scan = RunGetWorkload(bpm.get(), page_ids, BUSTUB_GET_THREAD, duration_ms);
+    stop = true;
+    scan_thread.join();
+
+    auto get_per_sec = get_cnt / static_cast<double>(duration_ms) * 1000;
+    auto get_with_scan_per_sec = get_cnt_with_scan / static_cast<double>(duration_ms) * 1000;
+    fmt::print("<<< BEGIN\n");
+    fmt::print("get: {}\n", get_per_sec);
+    fmt::print("get with scan: {}\n", get_with_scan_per_sec);
+    fmt::print("drop: {:.2f}%\n", get_cnt == 0 ? 0.0 : (1 - get_with_scan_per_sec / get_per_sec) * 100);
+    fmt::print(">>> END\n");
+    return 0;
+  }
 
   fmt::print(stderr, "[info] benchmark start\n");
 
@@ -171,6 +466,7 @@ auto main(int argc, char **argv) -> int {
         if (page == nullptr) {
           continue;
         }
+        bpm->ReadAheadHint(page_ids[page_idx], page_ids[(page_idx + 1) % BUSTUB_PAGE_CNT], nullptr);
 
         char &ch = page->GetData()[page_idx % 1024];
         page->WLatch();
@@ -227,6 +523,13 @@ auto main(int argc, char **argv) -> int {
   }
 
   total_metrics.Report();
+  auto fetch_cnt = total_metrics.scan_cnt_ + total_metrics.get_cnt_;
+  fmt::print(stderr, "[info] foreground_write_backs={}, cleaner_write_backs={}, hit_ratio={:.4f}\n",
+             bpm->GetForegroundWriteBacks(), bpm->GetCleanerWriteBacks(),
+             fetch_cnt == 0 ? 0.0 : 1 - counting_disk_manager.reads_ / static_cast<double>(fetch_cnt));
+
+  bpm.reset();
+  disk_manager->ShutDown();
 
   return 0;
 }
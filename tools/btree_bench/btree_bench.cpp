@@ -1,3 +1,4 @@
+#include <atomic>
 #include <chrono>
 #include <iostream>
 #include <memory>
@@ -38,6 +39,9 @@ static const size_t LRU_K_SIZE = 4;
 static const size_t BUSTUB_BPM_SIZE = 256;
 static const size_t TOTAL_KEYS = 100000;
 static const size_t KEY_MODIFY_RANGE = 2048;
+static const size_t BUSTUB_MAX_SCALING_THREAD = 32;
+
+using BenchTree = bustub::BPlusTree<bustub::GenericKey<8>, bustub::RID, bustub::GenericComparator<8>>;
 
 struct BTreeTotalMetrics {
   uint64_t write_cnt_{0};
@@ -110,6 +114,47 @@ auto KeyWillVanish(size_t key) -> bool { return key % 7 == 0; }
 // These keys will be overwritten to a new value
 auto KeyWillChange(size_t key) -> bool { return key % 5 == 0; }
 
+/**
+ * Run num_threads threads against the tree for duration_ms. Inserting threads insert increasing keys from their own
+ * range above key_base, so that they only meet inside the tree; reading threads look up random preloaded keys.
+ * @return the number of operations done
+ */
+auto RunScalingStep(BenchTree *index, size_t num_threads, bool insert, size_t key_base, uint64_t duration_ms)
+    -> uint64_t {
+  std::vector<std::thread> threads;
+  std::atomic<uint64_t> total_cnt{0};
+  for (size_t thread_id = 0; thread_id < num_threads; thread_id++) {
+    threads.emplace_back([thread_id, index, insert, key_base, duration_ms, &total_cnt] {
+      BTreeMetrics metrics(fmt::format("{} {:>2}", insert ? "write" : "read ", thread_id), duration_ms);
+      metrics.Begin();
+      std::random_device r;
+      std::default_random_engine gen(r());
+      std::uniform_int_distribution<size_t> dis(0, TOTAL_KEYS - 1);
+      bustub::GenericKey<8> index_key;
+      bustub::RID rid;
+      std::vector<bustub::RID> rids;
+      auto key = key_base + (thread_id << 32);
+      while (!metrics.ShouldFinish()) {
+        if (insert) {
+          rid.Set(static_cast<int32_t>(key >> 32), static_cast<uint32_t>(key));
+          index_key.SetFromInteger(key++);
+          index->Insert(index_key, rid, nullptr);
+        } else {
+          rids.clear();
+          index_key.SetFromInteger(dis(gen));
+          index->GetValue(index_key, &rids);
+        }
+        metrics.Tick();
+      }
+      total_cnt += metrics.cnt_;
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return total_cnt;
+}
+
 // NOLINTNEXTLINE
 auto main(int argc, char **argv) -> int {
   using bustub::AccessType;
@@ -119,6 +164,10 @@ auto main(int argc, char **argv) -> int {
 
   argparse::ArgumentParser program("bustub-btree-bench");
   program.add_argument("--duration").help("run btree bench for n milliseconds");
+  program.add_argument("--scaling")
+      .help("report insert and read throughput from 1 to 32 threads, running each step for --duration milliseconds")
+      .default_value(false)
+      .implicit_value(true);
 
   try {
     program.parse_args(argc, argv);
@@ -157,6 +206,22 @@ auto main(int argc, char **argv) -> int {
     index.Insert(index_key, rid, nullptr);
   }
 
+  if (program.get<bool>("--scaling")) {
+    fmt::print(stderr, "[info] scaling benchmark start\n");
+    fmt::print("<<< BEGIN\n");
+    // Every step inserts into a key range of its own, above the preloaded keys.
+    size_t key_base = size_t{1} << 40;
+    for (size_t num_threads = 1; num_threads <= BUSTUB_MAX_SCALING_THREAD; num_threads *= 2) {
+      auto write_cnt = RunScalingStep(&index, num_threads, true, key_base, duration_ms);
+      auto read_cnt = RunScalingStep(&index, num_threads, false, 0, duration_ms);
+      fmt::print("threads={:<2} write: {} read: {}\n", num_threads, write_cnt / static_cast<double>(duration_ms) * 1000,
+                 read_cnt / static_cast<double>(duration_ms) * 1000);
+      key_base += size_t{1} << 40;
+    }
+    fmt::print(">>> END\n");
+    return 0;
+  }
+
   fmt::print(stderr, "[info] benchmark start\n");
 
   BTreeTotalMetrics total_metrics;
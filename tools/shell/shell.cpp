@@ -1,4 +1,7 @@
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <string>
 #include "binder/binder.h"
 #include "common/bustub_instance.h"
@@ -27,14 +30,22 @@ auto GetWidthOfUtf8(const void *beg, const void *end, size_t *width) -> int {
 auto main(int argc, char **argv) -> int {
   ft_set_u8strwid_func(&GetWidthOfUtf8);
 
-  auto bustub = std::make_unique<bustub::BustubInstance>("test.db");
-
   auto default_prompt = "bustub> ";
   auto emoji_prompt = "\U0001f6c1> ";  // the bathtub emoji
   bool use_emoji_prompt = false;
   bool disable_tty = false;
+  size_t page_size = bustub::BUSTUB_PAGE_SIZE;
 
   for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--page-size") == 0 && i + 1 < argc) {
+      char *end = nullptr;
+      page_size = strtoul(argv[++i], &end, 10);
+      if (end == argv[i] || *end != '\0') {
+        std::cerr << "--page-size expects a number of bytes, got " << argv[i] << std::endl;
+        return 1;
+      }
+      continue;
+    }
     if (strcmp(argv[i], "--emoji-prompt") == 0) {
       use_emoji_prompt = true;
       break;
@@ -45,6 +56,15 @@ auto main(int argc, char **argv) -> int {
     }
   }
 
+  std::unique_ptr<bustub::BustubInstance> bustub;
+  try {
+    bustub = std::make_unique<bustub::BustubInstance>("test.db", page_size);
+  } catch (bustub::Exception &ex) {
+    // e.g. an unsupported page size, or test.db was created with another one
+    std::cerr << ex.what() << std::endl;
+    return 1;
+  }
+
   bustub->GenerateMockTable();
 
   if (bustub->buffer_pool_manager_ != nullptr) {